@@ -151,6 +151,38 @@ coder::ByteArray PKCS1rsassa::sign(const RSAPrivateKey& K, const coder::ByteArra
 
 }
 
+/*
+ * PKCS 1 v1.5 signing of a batch of messages.
+ *
+ * All of the messages are encoded first, then the signature primitive
+ * is applied to the batch, so the key's setup is done once. Returns
+ * the signatures in message order.
+ */
+RSA::Signatures PKCS1rsassa::sign(const RSAPrivateKey& K, const Messages& M) {
+
+    int k = K.getBitLength() / 8;
+    RSAPrivateKey::Representatives m;
+    for (unsigned i = 0; i < M.size(); ++i) {
+        try {
+            m.push_back(os2ip(emsaPKCS1Encode(M[i], k)));
+        }
+        catch (EncodingException& e) {
+            if (std::string(e.what()) == "Intended encoded message length too short") {
+                throw BadParameterException("RSA modulus too short");
+            }
+            throw;
+        }
+    }
+
+    RSAPrivateKey::Representatives s(K.rsasp1(m));
+    Signatures S;
+    for (unsigned i = 0; i < s.size(); ++i) {
+        S.push_back(i2osp(s[i], k));
+    }
+    return S;
+
+}
+
 bool
 PKCS1rsassa::verify(const RSAPublicKey& K, const coder::ByteArray& M,
                                             const coder::ByteArray& S) {
@@ -8,6 +8,7 @@
 #include "exceptions/NoSuchAlgorithmException.h"
 #include "exceptions/EncodingException.h"
 #include "exceptions/BadParameterException.h"
+#include <algorithm>
 #include <cmath>
 
 namespace CK {
@@ -45,6 +46,25 @@ coder::ByteArray PSSrsassa::decrypt(const RSAPrivateKey& K, const coder::ByteArr
  */
 coder::ByteArray PSSrsassa::emsaPSSEncode(const coder::ByteArray& M, int emBits) {
 
+    // 4.  Generate a random octet string salt of length sLen; if sLen = 0,
+    //     then salt is the empty string.
+    coder::ByteArray salt(saltLength);
+    if (salt.getLength() > 0) {
+        FortunaSecureRandom rnd;
+        rnd.nextBytes(salt);
+    }
+
+    return emsaPSSEncode(M, emBits, salt);
+
+}
+
+/*
+ * Message signature encoding with the given salt, which must be
+ * saltLength octets.
+ */
+coder::ByteArray PSSrsassa::emsaPSSEncode(const coder::ByteArray& M, int emBits,
+                                                    const coder::ByteArray& salt) {
+
     // The check here for message size with respect to the hash input
     // size (~= 2 exabytes for SHA1) isn't necessary.
 
@@ -59,14 +79,6 @@ coder::ByteArray PSSrsassa::emsaPSSEncode(const coder::ByteArray& M, int emBits)
         throw EncodingException("Encoding error");
     }
 
-    // 4.  Generate a random octet string salt of length sLen; if sLen = 0,
-    //     then salt is the empty string.
-    coder::ByteArray salt(saltLength);
-    if (salt.getLength() > 0) {
-        FortunaSecureRandom rnd;
-        rnd.nextBytes(salt);
-    }
-
     //std::cout << "emsaPSSEncode salt = " << salt << std::endl << std::endl;
 
     // 5.  Let
@@ -334,6 +346,45 @@ coder::ByteArray PSSrsassa::sign(const RSAPrivateKey& K, const coder::ByteArray&
 
 }
 
+/*
+ * EMSA-PSS signing of a batch of messages.
+ *
+ * The salts for all of the messages are drawn from one generator and
+ * the signature primitive is applied to the whole batch, so the key's
+ * setup is done once. Returns the signatures in message order.
+ */
+RSA::Signatures PSSrsassa::sign(const RSAPrivateKey& K, const Messages& M) {
+
+    // Requests to the generator are kept well inside its 16 bit
+    // request length.
+    const unsigned maxRequest = 0x8000;
+    coder::ByteArray salts;
+    if (saltLength > 0) {
+        FortunaSecureRandom rnd;
+        unsigned perRequest = std::max(1U, maxRequest / saltLength);
+        for (unsigned i = 0; i < M.size(); i += perRequest) {
+            coder::ByteArray block(std::min<unsigned>(perRequest, M.size() - i) * saltLength);
+            rnd.nextBytes(block);
+            salts.append(block);
+        }
+    }
+
+    RSAPrivateKey::Representatives m;
+    for (unsigned i = 0; i < M.size(); ++i) {
+        coder::ByteArray salt(salts.range(i * saltLength, saltLength));
+        m.push_back(os2ip(emsaPSSEncode(M[i], K.getBitLength() - 1, salt)));
+    }
+
+    RSAPrivateKey::Representatives s(K.rsasp1(m));
+    unsigned k = K.getBitLength() / 8;
+    Signatures S;
+    for (unsigned i = 0; i < s.size(); ++i) {
+        S.push_back(i2osp(s[i], k));
+    }
+    return S;
+
+}
+
 /**
  *
  * Verify an EMSA-PSS encoded signature.
@@ -85,7 +85,7 @@ BigInteger RSA::rsaep(const RSAPublicKey& K, const BigInteger& p) {
     }
 
     // 2. Let c = m^e mod n.
-    return p.modPow(K.getPublicExponent(), K.getModulus());
+    return K.getModulusContext().modPow(p, K.getPublicExponent());
 
 }
 
@@ -116,7 +116,7 @@ BigInteger RSA::rsavp1(const RSAPublicKey& K, const BigInteger& s) {
 
     //std:: cout << "rsavp1 s = " << s << std::endl;
     // 2. Let m = s^e mod n.
-    BigInteger result(s.modPow(K.getPublicExponent(), K.getModulus()));
+    BigInteger result(K.getModulusContext().modPow(s, K.getPublicExponent()));
     //std::cout << "rsavp1 result = " << result << std::endl;
     return result;
 
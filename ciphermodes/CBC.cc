@@ -1,7 +1,6 @@
 #include "ciphermodes/CBC.h"
 #include "cipher/BlockCipher.h"
 #include "exceptions/BadParameterException.h"
-#include <deque>
 
 namespace CK {
 
@@ -35,89 +34,102 @@ coder::ByteArray CBC::encrypt(const coder::ByteArray& iv, const coder::ByteArray
 
 coder::ByteArray CBC::decrypt(const coder::ByteArray& ciphertext, const coder::ByteArray& key) {
 
-    coder::ByteArray plaintext;
-    coder::ByteArray padded;
-    unsigned textSize = ciphertext.getLength();
-    unsigned blockOffset = 0;
-    coder::ByteArray cblock;
-    if (textSize % blockSize != 0) {
-        while (textSize > blockSize) {
-            cblock = ciphertext.range(blockOffset, blockSize);
-            textSize -= blockSize;
-            blockOffset += blockSize;
-        }
-        // Decrypt second to last block.
-        coder::ByteArray padBlock(cipher->decrypt(cblock, key));
-        // Get padding bits.
-        coder::ByteArray padBytes(padBlock.range(textSize, blockSize - textSize));
-        padded = ciphertext;
-        // Pad the original ciphertext.
-        padded.append(padBytes);
-        // Extract the last 2 blocks.
-        coder::ByteArray b1(padded.range(padded.getLength()-(blockSize*2), blockSize));
-        coder::ByteArray b2(padded.range(padded.getLength()-(blockSize), blockSize));
-        // Swap blocks.
-        padded = padded.range(0, padded.getLength()-(blockSize*2));
-        padded.append(b2);
-        padded.append(b1);
-    }
-    else {
-        padded = ciphertext;
+    return decryptRange(ciphertext, 0, ciphertext.getLength(), key);
+
+}
+
+/*
+ * Decrypt from the range of the ciphertext. A partial last block means
+ * the cipherbits were stolen. The last two blocks are then swapped and
+ * the stolen block is completed from the decryption of the block before
+ * it.
+ */
+coder::ByteArray CBC::decryptRange(const coder::ByteArray& ciphertext, unsigned offset,
+                                    unsigned length, const coder::ByteArray& key) {
+
+    unsigned partial = length % blockSize;
+    if (partial != 0 && length < blockSize) {
+        throw BadParameterException("CBC text shorter than a block");
     }
-    textSize = padded.getLength();
-    blockOffset = 0;
+
+    coder::ByteArray plaintext;
+    unsigned chained = partial != 0 ? length - partial - blockSize : length;
     coder::ByteArray input(iv);
-    while (textSize > 0) {
-        coder::ByteArray cipherblock(padded.range(blockOffset, blockSize));
-        coder::ByteArray plainblock(decrypt(input, cipherblock, key));
-        plaintext.append(plainblock);
+    for (unsigned blockOffset = 0; blockOffset < chained; blockOffset += blockSize) {
+        coder::ByteArray cipherblock(ciphertext.range(offset + blockOffset, blockSize));
+        plaintext.append(decrypt(input, cipherblock, key));
         input = cipherblock;
-        blockOffset += blockSize;
-        textSize -= blockSize;
     }
-    return plaintext.range(0, ciphertext.getLength());
+
+    if (partial != 0) {
+        // Decrypt second to last block.
+        coder::ByteArray cn(ciphertext.range(offset + chained, blockSize));
+        coder::ByteArray padBlock(cipher->decrypt(cn, key));
+        // The padding bits complete the stolen block.
+        coder::ByteArray cn1(ciphertext.range(offset + chained + blockSize, partial));
+        cn1.append(padBlock.range(partial, blockSize - partial));
+        plaintext.append(decrypt(input, cn1, key));
+        plaintext.append((padBlock ^ cn1).range(0, partial));
+    }
+    return plaintext;
 
 }
 
 coder::ByteArray CBC::encrypt(const coder::ByteArray& plaintext, const coder::ByteArray& key) {
 
     coder::ByteArray ciphertext;
-    coder::ByteArray padded(plaintext);
-    // plaintext is padded. Need to steal cipherbits
-    bool steal = padded.getLength() % blockSize != 0;
-    while (padded.getLength() % blockSize != 0) {
-        padded.append(0);
-    }
-    unsigned textLength = padded.getLength();
-    coder::ByteArray input = iv;
-    coder::ByteArray cipherblock;
-    std::deque<coder::ByteArray> blocks;
-    unsigned blockStart = 0;
-    while (textLength > 0) {
-        coder::ByteArray plainblock(padded.range(blockStart, blockSize));
-        coder::ByteArray cipherblock(encrypt(input, plainblock, key));
-        input = cipherblock;
-        blocks.push_back(cipherblock);
-        blockStart += blockSize;
-        textLength -= blockSize;
-    }
+    Buffer out(ciphertext);
+    encryptStream(plaintext, key, out);
+    return ciphertext;
 
-    if (steal) {
-        // Swap last two blocks
-        coder::ByteArray cn(blocks.back());
-        blocks.pop_back();
-        coder::ByteArray cn1(blocks.back());
-        blocks.pop_back();
-        blocks.push_back(cn);
-        blocks.push_back(cn1);
-    }
+}
 
-    while (blocks.size() > 0) {
-        ciphertext.append(blocks.front());
-        blocks.pop_front();
+/*
+ * Each block is written as it is chained. If the last block is partial
+ * it is padded with zeros and its cipherbits are stolen, so the last
+ * two blocks are swapped and the final one truncated. The previous
+ * block is held back for that.
+ */
+void CBC::encryptStream(const coder::ByteArray& plaintext, const coder::ByteArray& key,
+                                    Output& out) {
+
+    unsigned textLength = plaintext.getLength();
+    bool steal = textLength % blockSize != 0;
+    if (steal && textLength < blockSize) {
+        throw BadParameterException("CBC text shorter than a block");
     }
 
-    return ciphertext.range(0, plaintext.getLength());
+    coder::ByteArray input(iv);
+    coder::ByteArray held;
+    for (unsigned blockStart = 0; blockStart < textLength; blockStart += blockSize) {
+        bool last = blockStart + blockSize >= textLength;
+        coder::ByteArray plainblock;
+        if (!last || !steal) {
+            plainblock = plaintext.range(blockStart, blockSize);
+        }
+        else {
+            plainblock = plaintext.range(blockStart, textLength - blockStart);
+            while (plainblock.getLength() < blockSize) {
+                plainblock.append(0);
+            }
+        }
+        coder::ByteArray cipherblock(encrypt(input, plainblock, key));
+        input = cipherblock;
+        if (!steal) {
+            out.write(cipherblock);
+        }
+        else if (!last) {
+            if (held.getLength() > 0) {
+                out.write(held);
+            }
+            held = cipherblock;
+        }
+        else {
+            // Swap last two blocks
+            out.write(cipherblock);
+            out.write(held.range(0, textLength - blockStart));
+        }
+    }
 
 }
 
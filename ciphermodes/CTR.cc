@@ -18,9 +18,19 @@ CTR::~CTR() {
 
 coder::ByteArray CTR::decrypt(const coder::ByteArray& ciphertext, const coder::ByteArray& key) {
 
+    return decryptRange(ciphertext, 0, ciphertext.getLength(), key);
+
+}
+
+/*
+ * Decrypt length bytes of the ciphertext starting at offset.
+ */
+coder::ByteArray CTR::decryptRange(const coder::ByteArray& ciphertext, unsigned offset,
+                                    unsigned length, const coder::ByteArray& key) {
+
     coder::ByteArray P;
 
-    double cs = ciphertext.getLength();
+    double cs = length;
     uint32_t blockSize = cipher->blockSize();
     uint32_t blockCount = ceil(cs / blockSize);
 
@@ -28,11 +38,11 @@ coder::ByteArray CTR::decrypt(const coder::ByteArray& ciphertext, const coder::B
         uint32_t index = i * blockSize;
         incrementCounter();
         coder::ByteArray pBlock(cipher->encrypt(counter, key));
-        if (index + blockSize < ciphertext.getLength()) { // Whole block
-            P.append(pBlock ^ ciphertext.range(index, blockSize));
+        if (index + blockSize < length) { // Whole block
+            P.append(pBlock ^ ciphertext.range(offset + index, blockSize));
         }
         else {          // Partial block, xor with encrypted counter LSB
-            coder::ByteArray partial(ciphertext.range(index, ciphertext.getLength() - index));
+            coder::ByteArray partial(ciphertext.range(offset + index, length - index));
             coder::ByteArray pctr(pBlock.range(0, partial.getLength()));
             P.append(partial ^ pctr);
         }
@@ -45,6 +55,17 @@ coder::ByteArray CTR::decrypt(const coder::ByteArray& ciphertext, const coder::B
 coder::ByteArray CTR::encrypt(const coder::ByteArray& plaintext, const coder::ByteArray& key) {
 
     coder::ByteArray C;
+    Buffer out(C);
+    encryptStream(plaintext, key, out);
+    return C;
+
+}
+
+/*
+ * Each block of ciphertext is written as it is produced.
+ */
+void CTR::encryptStream(const coder::ByteArray& plaintext, const coder::ByteArray& key,
+                                    Output& out) {
 
     double ps = plaintext.getLength();
     uint32_t blockSize = cipher->blockSize();
@@ -55,17 +76,15 @@ coder::ByteArray CTR::encrypt(const coder::ByteArray& plaintext, const coder::By
         incrementCounter();
         coder::ByteArray cBlock(cipher->encrypt(counter, key));
         if (index + blockSize < plaintext.getLength()) { // Whole block
-            C.append(cBlock ^ plaintext.range(index, blockSize));
+            out.write(cBlock ^ plaintext.range(index, blockSize));
         }
         else {          // Partial block, xor with encrypted counter LSB
             coder::ByteArray partial(plaintext.range(index, plaintext.getLength() - index));
             coder::ByteArray pctr(cBlock.range(0, partial.getLength()));
-            C.append(partial ^ pctr);
+            out.write(partial ^ pctr);
         }
     }
 
-    return C;
-
 }
 
 void CTR::incrementCounter() {
@@ -0,0 +1,120 @@
+#include "ciphermodes/EtM.h"
+#include "mac/HMAC.h"
+#include "digest/SHA256.h"
+#include "data/ConstantTime.h"
+#include "exceptions/AuthenticationException.h"
+#include <memory>
+
+namespace CK {
+
+/*
+ * Passes each chunk of ciphertext to the HMAC as the cipher mode
+ * produces it, and collects the chunks.
+ */
+class EtMOutput : public BlockCipherMode::Output {
+
+    public:
+        EtMOutput(HMAC *h, coder::ByteArray& c) : hmac(h), C(c) {}
+
+    public:
+        void write(const coder::ByteArray& chunk)
+                { hmac->update(chunk); C.append(chunk); }
+
+    private:
+        HMAC *hmac;
+        coder::ByteArray& C;
+
+};
+
+static const uint8_t ENCRYPTION_INFO[] = { 'E', 't', 'M', ' ', 'e', 'n', 'c', 'r',
+                                           'y', 'p', 't', 'i', 'o', 'n' };
+static const uint8_t MAC_INFO[] = { 'E', 't', 'M', ' ', 'M', 'A', 'C' };
+
+EtM::EtM(BlockCipherMode *c, HMAC* h)
+: cipher(c),
+  hmac(h),
+  kdf(new SHA256) {
+}
+
+EtM::~EtM() {
+
+    delete hmac;
+    delete cipher;
+
+}
+
+/*
+ * Verify the appended tag and decrypt. The ciphertext is never
+ * decrypted if the tag doesn't match. The tag and the cipher both
+ * work from the range of the ciphertext, not a copy. The computed tag
+ * is finalized on the stack, only a long SHAKE tag needs a heap
+ * buffer.
+ */
+coder::ByteArray EtM::decrypt(const coder::ByteArray& ciphertext,
+                                    const coder::ByteArray& key) {
+
+    unsigned digestLength = hmac->getDigestLength();
+    if (ciphertext.getLength() < digestLength) {
+        throw AuthenticationException("EtM failed authentication");
+    }
+
+    deriveKeys(key);
+    unsigned macOffset = ciphertext.getLength() - digestLength;
+    hmac->setKey(macKey);
+    hmac->update(IV);
+    hmac->update(ciphertext, 0, macOffset);
+    uint8_t stackTag[MAX_TAG];
+    std::unique_ptr<uint8_t[]> heapTag(digestLength > MAX_TAG ? new uint8_t[digestLength] : 0);
+    uint8_t *tag = heapTag ? heapTag.get() : stackTag;
+    hmac->final(tag);
+    if (!ConstantTime::equals(tag, ciphertext, macOffset, digestLength)) {
+        throw AuthenticationException("EtM failed authentication");
+    }
+
+    return cipher->decryptRange(ciphertext, 0, macOffset, encryptionKey);
+
+}
+
+/*
+ * Encrypt the plaintext and append the tag. The HMAC is updated with
+ * each chunk of ciphertext as the mode writes it.
+ */
+coder::ByteArray EtM::encrypt(const coder::ByteArray& plaintext,
+                                    const coder::ByteArray& key) {
+
+    deriveKeys(key);
+    coder::ByteArray C;
+    hmac->setKey(macKey);
+    hmac->update(IV);
+    EtMOutput out(hmac, C);
+    cipher->encryptStream(plaintext, encryptionKey, out);
+    C.append(hmac->final());
+    return C;
+
+}
+
+void EtM::setIV(const coder::ByteArray& iv) {
+
+    IV = iv;
+    cipher->setIV(iv);
+
+}
+
+/*
+ * Derive the encryption key, the same length as the key, and a digest
+ * length MAC key. They are kept until the key changes.
+ */
+void EtM::deriveKeys(const coder::ByteArray& key) {
+
+    if (macKey.getLength() == 0 || !ConstantTime::equals(key, masterKey)) {
+        coder::ByteArray prk(kdf.extract(coder::ByteArray(), key));
+        encryptionKey = kdf.expand(prk, coder::ByteArray(ENCRYPTION_INFO,
+                                    sizeof(ENCRYPTION_INFO)), key.getLength());
+        macKey = kdf.expand(prk, coder::ByteArray(MAC_INFO, sizeof(MAC_INFO)),
+                                    hmac->getDigestLength());
+        masterKey = key;
+    }
+
+}
+
+}
@@ -3,6 +3,7 @@
 #include "coder/Unsigned64.h"
 #include "coder/Unsigned32.h"
 #include "data/BigInteger.h"
+#include "data/ConstantTime.h"
 #include "exceptions/BadParameterException.h"
 #include "exceptions/AuthenticationException.h"
 #include <deque>
@@ -63,7 +64,7 @@ coder::ByteArray GCM::decrypt(const coder::ByteArray& C, const coder::ByteArray&
 
     coder::ByteArray Tp(GHASH(H, A, ciphertext));
     Tp = Tp ^ cipher->encrypt(Y0, K);
-    if (T != Tp) {
+    if (!ConstantTime::equals(T, Tp)) {
         throw AuthenticationException("GCM AEAD failed authentication");
     }
 
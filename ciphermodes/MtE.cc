@@ -1,5 +1,7 @@
 #include "ciphermodes/MtE.h"
 #include "mac/HMAC.h"
+#include "data/ConstantTime.h"
+#include <memory>
 
 namespace CK {
 
@@ -21,13 +23,22 @@ coder::ByteArray MtE::decrypt(const coder::ByteArray& ciphertext,
 
     coder::ByteArray ptm(cipher->decrypt(ciphertext, key));
     unsigned digestLength = hmac->getDigestLength();
+    // Too short to hold a MAC. Truncated or forged.
+    if (ptm.getLength() < digestLength) {
+        authenticated = false;
+        return coder::ByteArray();
+    }
     unsigned hmacOffset = ptm.getLength() - digestLength;
-    coder::ByteArray mac(ptm.range(hmacOffset, digestLength));
-    coder::ByteArray message(ptm.range(0, hmacOffset));
     hmac->setKey(key);
-    hmac->setMessage(message);
-    authenticated = hmac->authenticate(mac);
-    return message;
+    hmac->update(ptm, 0, hmacOffset);
+    // Fixed length MACs are finalized on the stack.
+    uint8_t stackMac[MAX_MAC];
+    std::unique_ptr<uint8_t[]> heapMac(digestLength > MAX_MAC ? new uint8_t[digestLength] : 0);
+    uint8_t *mac = heapMac ? heapMac.get() : stackMac;
+    hmac->final(mac);
+    authenticated = ConstantTime::equals(mac, ptm, hmacOffset, digestLength);
+    ptm.truncate(digestLength);
+    return ptm;
 
 }
 
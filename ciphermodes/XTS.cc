@@ -0,0 +1,289 @@
+#include "ciphermodes/XTS.h"
+#include "cipher/BlockCipher.h"
+#include "data/ConstantTime.h"
+#include "exceptions/BadParameterException.h"
+
+namespace CK {
+
+XTS::XTS(BlockCipher *c)
+: cipher(c),
+  tweak(16, 0) {
+
+    blockSize = cipher->blockSize();
+    if (blockSize != 16) {
+        throw BadParameterException("Invalid cipher block size");
+    }
+
+}
+
+XTS::~XTS() {
+
+    delete cipher;
+
+}
+
+/*
+ * Decrypt a single data unit with the current tweak.
+ */
+coder::ByteArray XTS::decrypt(const coder::ByteArray& ciphertext, const coder::ByteArray& key) {
+
+    coder::ByteArray K1;
+    coder::ByteArray K2;
+    splitKey(key, K1, K2);
+    return decryptUnit(ciphertext, tweak, K1, K2);
+
+}
+
+/*
+ * Decrypt a run of consecutive sectors. The ciphertext length must be
+ * a multiple of the sector size. Sector n is decrypted with the
+ * tweak firstSector + n.
+ */
+coder::ByteArray XTS::decryptSectors(const coder::ByteArray& ciphertext,
+                                        const coder::ByteArray& key,
+                                        uint64_t firstSector, unsigned sectorSize) {
+
+    if (sectorSize < blockSize || ciphertext.getLength() % sectorSize != 0) {
+        throw BadParameterException("XTS invalid sector size");
+    }
+
+    coder::ByteArray K1;
+    coder::ByteArray K2;
+    splitKey(key, K1, K2);
+
+    coder::ByteArray P;
+    coder::ByteArray T(16, 0);
+    unsigned sectors = ciphertext.getLength() / sectorSize;
+    for (unsigned s = 0; s < sectors; ++s) {
+        uint64_t sector = firstSector + s;
+        for (int i = 0; i < 8; ++i) {
+            T[i] = (sector >> (i * 8)) & 0xff;
+        }
+        P.append(decryptUnit(ciphertext.range(s * sectorSize, sectorSize), T, K1, K2));
+    }
+
+    return P;
+
+}
+
+/*
+ * Decrypt one data unit.
+ *
+ * The final partial block is recovered by reversing the ciphertext
+ * stealing step. The last two tweaks are applied in swapped order.
+ */
+coder::ByteArray XTS::decryptUnit(const coder::ByteArray& ciphertext,
+                                        const coder::ByteArray& i,
+                                        const coder::ByteArray& K1,
+                                        const coder::ByteArray& K2) {
+
+    unsigned length = ciphertext.getLength();
+    if (length < blockSize) {
+        throw BadParameterException("XTS data unit too short");
+    }
+
+    unsigned m = length / blockSize;
+    unsigned b = length % blockSize;
+    // Number of blocks that are not involved in stealing.
+    unsigned head = b == 0 ? m : m - 1;
+
+    coder::ByteArray mask(tweakSequence(cipher->encrypt(i, K2), b == 0 ? m : m + 1));
+    coder::ByteArray headMask(mask.range(0, head * blockSize));
+    coder::ByteArray X(ciphertext.range(0, head * blockSize) ^ headMask);
+    coder::ByteArray Y;
+    for (unsigned j = 0; j < head; ++j) {
+        Y.append(cipher->decrypt(X.range(j * blockSize, blockSize), K1));
+    }
+    coder::ByteArray P(Y ^ headMask);
+
+    if (b != 0) {
+        coder::ByteArray Tm1(mask.range((m - 1) * blockSize, blockSize));
+        coder::ByteArray Tm(mask.range(m * blockSize, blockSize));
+        coder::ByteArray Cm1(ciphertext.range((m - 1) * blockSize, blockSize));
+        coder::ByteArray Cm(ciphertext.range(m * blockSize, b));
+        // Decrypt second to last block with the last tweak.
+        coder::ByteArray PP(cipher->decrypt(Cm1 ^ Tm, K1) ^ Tm);
+        // Restore the stolen ciphertext bits.
+        coder::ByteArray CC(Cm);
+        CC.append(PP.range(b, blockSize - b));
+        P.append(cipher->decrypt(CC ^ Tm1, K1) ^ Tm1);
+        P.append(PP.range(0, b));
+    }
+
+    return P;
+
+}
+
+/*
+ * Encrypt a single data unit with the current tweak.
+ */
+coder::ByteArray XTS::encrypt(const coder::ByteArray& plaintext, const coder::ByteArray& key) {
+
+    coder::ByteArray K1;
+    coder::ByteArray K2;
+    splitKey(key, K1, K2);
+    return encryptUnit(plaintext, tweak, K1, K2);
+
+}
+
+/*
+ * Encrypt a run of consecutive sectors. The plaintext length must be
+ * a multiple of the sector size. Sector n is encrypted with the
+ * tweak firstSector + n.
+ */
+coder::ByteArray XTS::encryptSectors(const coder::ByteArray& plaintext,
+                                        const coder::ByteArray& key,
+                                        uint64_t firstSector, unsigned sectorSize) {
+
+    if (sectorSize < blockSize || plaintext.getLength() % sectorSize != 0) {
+        throw BadParameterException("XTS invalid sector size");
+    }
+
+    coder::ByteArray K1;
+    coder::ByteArray K2;
+    splitKey(key, K1, K2);
+
+    coder::ByteArray C;
+    coder::ByteArray T(16, 0);
+    unsigned sectors = plaintext.getLength() / sectorSize;
+    for (unsigned s = 0; s < sectors; ++s) {
+        uint64_t sector = firstSector + s;
+        for (int i = 0; i < 8; ++i) {
+            T[i] = (sector >> (i * 8)) & 0xff;
+        }
+        C.append(encryptUnit(plaintext.range(s * sectorSize, sectorSize), T, K1, K2));
+    }
+
+    return C;
+
+}
+
+/*
+ * Encrypt one data unit.
+ *
+ * The whole tweak sequence for the unit is computed up front so the
+ * pre and post whitening are single passes over the unit. If the unit
+ * is not a multiple of the block size, the last two blocks are
+ * produced with ciphertext stealing. As in CBC, the second to last
+ * cipher block supplies the padding bits for the final block and the
+ * two blocks are swapped.
+ */
+coder::ByteArray XTS::encryptUnit(const coder::ByteArray& plaintext,
+                                        const coder::ByteArray& i,
+                                        const coder::ByteArray& K1,
+                                        const coder::ByteArray& K2) {
+
+    unsigned length = plaintext.getLength();
+    if (length < blockSize) {
+        throw BadParameterException("XTS data unit too short");
+    }
+
+    unsigned m = length / blockSize;
+    unsigned b = length % blockSize;
+    // Number of blocks that are not involved in stealing.
+    unsigned head = b == 0 ? m : m - 1;
+
+    coder::ByteArray mask(tweakSequence(cipher->encrypt(i, K2), b == 0 ? m : m + 1));
+    coder::ByteArray headMask(mask.range(0, head * blockSize));
+    coder::ByteArray X(plaintext.range(0, head * blockSize) ^ headMask);
+    coder::ByteArray Y;
+    for (unsigned j = 0; j < head; ++j) {
+        Y.append(cipher->encrypt(X.range(j * blockSize, blockSize), K1));
+    }
+    coder::ByteArray C(Y ^ headMask);
+
+    if (b != 0) {
+        coder::ByteArray Tm1(mask.range((m - 1) * blockSize, blockSize));
+        coder::ByteArray Tm(mask.range(m * blockSize, blockSize));
+        coder::ByteArray Pm1(plaintext.range((m - 1) * blockSize, blockSize));
+        coder::ByteArray Pm(plaintext.range(m * blockSize, b));
+        coder::ByteArray CC(cipher->encrypt(Pm1 ^ Tm1, K1) ^ Tm1);
+        // Steal the padding bits from the second to last block.
+        coder::ByteArray PP(Pm);
+        PP.append(CC.range(b, blockSize - b));
+        // Swap blocks.
+        C.append(cipher->encrypt(PP ^ Tm, K1) ^ Tm);
+        C.append(CC.range(0, b));
+    }
+
+    return C;
+
+}
+
+/*
+ * Set the tweak value for the next data unit.
+ */
+void XTS::setIV(const coder::ByteArray& iv) {
+
+    if (iv.getLength() != blockSize) {
+        throw BadParameterException("XTS Invalid tweak");
+    }
+    tweak = iv;
+
+}
+
+/*
+ * Set the tweak value from a sector number. The sector number is
+ * encoded little-endian per IEEE 1619.
+ */
+void XTS::setSector(uint64_t sector) {
+
+    for (int i = 0; i < 16; ++i) {
+        tweak[i] = i < 8 ? (sector >> (i * 8)) & 0xff : 0;
+    }
+
+}
+
+/*
+ * Split the double length key into the data key and the tweak key.
+ * IEEE 1619 requires the two halves to differ. The comparison doesn't
+ * stop at the first differing byte.
+ */
+void XTS::splitKey(const coder::ByteArray& key, coder::ByteArray& K1,
+                                                coder::ByteArray& K2) const {
+
+    unsigned half = key.getLength() / 2;
+    if (half == 0 || key.getLength() % 2 != 0) {
+        throw BadParameterException("XTS invalid key length");
+    }
+    K1 = key.range(0, half);
+    K2 = key.range(half, half);
+    if (ConstantTime::equals(K1, K2)) {
+        throw BadParameterException("XTS data and tweak keys are the same");
+    }
+
+}
+
+/*
+ * Compute the tweak sequence T(j) = T(0) * alpha^j for j < blocks.
+ *
+ * The tweak is held as two little-endian 64 bit lanes so each
+ * multiplication by alpha in GF(2^128) is a pair of word shifts and
+ * a conditional reduction with the polynomial x^128 + x^7 + x^2 + x + 1.
+ */
+coder::ByteArray XTS::tweakSequence(const coder::ByteArray& T0, unsigned blocks) const {
+
+    uint64_t lo = 0;
+    uint64_t hi = 0;
+    for (int i = 7; i >= 0; --i) {
+        lo = (lo << 8) | T0[i];
+        hi = (hi << 8) | T0[i + 8];
+    }
+
+    coder::ByteArray T(blocks * 16);
+    for (unsigned j = 0; j < blocks; ++j) {
+        unsigned offset = j * 16;
+        for (int i = 0; i < 8; ++i) {
+            T[offset + i] = (lo >> (i * 8)) & 0xff;
+            T[offset + i + 8] = (hi >> (i * 8)) & 0xff;
+        }
+        uint64_t carry = hi >> 63;
+        hi = (hi << 1) | (lo >> 63);
+        lo = (lo << 1) ^ (carry * 0x87);
+    }
+
+    return T;
+
+}
+
+}
@@ -0,0 +1,95 @@
+#include "data/CPUFeatures.h"
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
+
+namespace CK {
+
+#if defined(__x86_64__) || defined(__i386__)
+/*
+ * Query the CPUID leaves once.
+ */
+struct CPUID {
+
+    CPUID()
+    : ecx1(0),
+      ebx7(0),
+      xcr0(0) {
+
+        unsigned eax, ebx, ecx, edx;
+        if (__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+            ecx1 = ecx;
+        }
+        if (__get_cpuid_max(0, 0) >= 7) {
+            __cpuid_count(7, 0, eax, ebx, ecx, edx);
+            ebx7 = ebx;
+        }
+        // OSXSAVE, leaf 1 ECX bit 27, says XGETBV is usable.
+        if ((ecx1 & (1 << 27)) != 0) {
+            __asm__ ("xgetbv" : "=a" (eax), "=d" (edx) : "c" (0));
+            xcr0 = eax;
+        }
+
+    }
+
+    unsigned ecx1;      // Leaf 1 feature flags
+    unsigned ebx7;      // Leaf 7 extended feature flags
+    unsigned xcr0;      // Register state enabled by the OS
+
+};
+
+static const CPUID& cpuid() {
+
+    static const CPUID id;
+    return id;
+
+}
+#endif
+
+/*
+ * AVX2 is leaf 7 EBX bit 5. XCR0 bits 1 and 2 are the XMM and YMM
+ * state.
+ */
+bool CPUFeatures::hasAVX2() {
+
+#if defined(__x86_64__) || defined(__i386__)
+    const CPUID& id(cpuid());
+    return (id.ebx7 & (1 << 5)) != 0 && (id.xcr0 & 0x06) == 0x06;
+#else
+    return false;
+#endif
+
+}
+
+/*
+ * AVX-512F is leaf 7 EBX bit 16. XCR0 bits 5 - 7 are the opmask and
+ * ZMM state.
+ */
+bool CPUFeatures::hasAVX512() {
+
+#if defined(__x86_64__) || defined(__i386__)
+    const CPUID& id(cpuid());
+    return (id.ebx7 & (1 << 16)) != 0 && (id.xcr0 & 0xe6) == 0xe6;
+#else
+    return false;
+#endif
+
+}
+
+/*
+ * SHA is leaf 7 EBX bit 29. SSSE3 is leaf 1 ECX bit 9, SSE4.1 is
+ * leaf 1 ECX bit 19.
+ */
+bool CPUFeatures::hasSHA() {
+
+#if defined(__x86_64__) || defined(__i386__)
+    const CPUID& id(cpuid());
+    return (id.ebx7 & (1 << 29)) != 0 && (id.ecx1 & (1 << 9)) != 0
+                                        && (id.ecx1 & (1 << 19)) != 0;
+#else
+    return false;
+#endif
+
+}
+
+}
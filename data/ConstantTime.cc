@@ -0,0 +1,59 @@
+#include "data/ConstantTime.h"
+
+namespace CK {
+
+/*
+ * The differences are collected in a volatile so the compiler can't
+ * turn the loop into an early exit.
+ */
+bool ConstantTime::equals(const uint8_t *a, const uint8_t *b, unsigned length) {
+
+    volatile uint8_t diff = 0;
+    for (unsigned i = 0; i < length; ++i) {
+        diff |= a[i] ^ b[i];
+    }
+    return diff == 0;
+
+}
+
+bool ConstantTime::equals(const uint8_t *a, const coder::ByteArray& b,
+                                            unsigned offset, unsigned length) {
+
+    if (offset > b.getLength() || length > b.getLength() - offset) {
+        return false;
+    }
+
+    volatile uint8_t diff = 0;
+    for (unsigned i = 0; i < length; ++i) {
+        diff |= a[i] ^ b[offset + i];
+    }
+    return diff == 0;
+
+}
+
+bool ConstantTime::equals(const coder::ByteArray& a, const coder::ByteArray& b) {
+
+    if (a.getLength() != b.getLength()) {
+        return false;
+    }
+    return equals(a, b, 0);
+
+}
+
+bool ConstantTime::equals(const coder::ByteArray& a, const coder::ByteArray& b,
+                                            unsigned offset) {
+
+    unsigned length = a.getLength();
+    if (offset > b.getLength() || length > b.getLength() - offset) {
+        return false;
+    }
+
+    volatile uint8_t diff = 0;
+    for (unsigned i = 0; i < length; ++i) {
+        diff |= a[i] ^ b[offset + i];
+    }
+    return diff == 0;
+
+}
+
+}
@@ -0,0 +1,59 @@
+#include "data/MappedFile.h"
+#include "exceptions/BadParameterException.h"
+#include "exceptions/DataException.h"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace CK {
+
+MappedFile::MappedFile(const std::string& path)
+: data(0),
+  length(0) {
+
+    // Non-blocking, so opening a FIFO with no writer doesn't hang
+    // before it can be rejected.
+    int fd = open(path.c_str(), O_RDONLY | O_NONBLOCK);
+    if (fd < 0) {
+        throw BadParameterException("Unable to open " + path);
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        throw DataException("Unable to read " + path);
+    }
+    // Pipes, sockets and devices report no useful size and can't be
+    // mapped. Hashing them as empty would be silently wrong.
+    if (!S_ISREG(st.st_mode)) {
+        close(fd);
+        throw BadParameterException(path + " is not a regular file");
+    }
+    length = st.st_size;
+
+    // An empty file can't be mapped.
+    if (length > 0) {
+        void *map = mmap(0, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (map == MAP_FAILED) {
+            close(fd);
+            throw DataException("Unable to map " + path);
+        }
+        data = static_cast<uint8_t*>(map);
+        madvise(map, length, MADV_SEQUENTIAL);
+    }
+
+    // The mapping holds its own reference to the file.
+    close(fd);
+
+}
+
+MappedFile::~MappedFile() {
+
+    if (data != 0) {
+        munmap(data, length);
+    }
+
+}
+
+}
@@ -0,0 +1,306 @@
+#include "data/MontgomeryContext.h"
+#include "data/BigInteger.h"
+#include "data/FixedMontgomery.h"
+#include <vector>
+#include <string.h>
+#include "NTL/ZZ.h"
+
+namespace CK {
+
+/*
+ * Conversions between ZZ and little endian limbs. x must fit in count
+ * limbs.
+ */
+static void toWords(uint64_t *words, const NTL::ZZ& x, unsigned count) {
+
+    std::vector<unsigned char> bytes(count * 8);
+    NTL::BytesFromZZ(&bytes[0], x, count * 8);
+    for (unsigned i = 0; i < count; ++i) {
+        uint64_t w = 0;
+        for (unsigned j = 8; j > 0; --j) {
+            w = (w << 8) | bytes[(i * 8) + j - 1];
+        }
+        words[i] = w;
+    }
+    memset(&bytes[0], 0, bytes.size());
+
+}
+
+static void fromWords(NTL::ZZ& x, const uint64_t *words, unsigned count) {
+
+    std::vector<unsigned char> bytes(count * 8);
+    for (unsigned i = 0; i < count; ++i) {
+        for (unsigned j = 0; j < 8; ++j) {
+            bytes[(i * 8) + j] = words[i] >> (j * 8);
+        }
+    }
+    NTL::ZZFromBytes(x, &bytes[0], count * 8);
+    memset(&bytes[0], 0, bytes.size());
+
+}
+
+/*
+ * R is the modulus length plus two bits, rounded up to whole 64 bit
+ * words, so the truncations and the shift fall on word boundaries.
+ * With R > 4n, multiply() can leave out the final subtraction of n.
+ * The fixed widths use R = 2^(64 limbs) and an R^2 mod n of their own.
+ */
+MontgomeryContext::MontgomeryContext(const BigInteger& modulus)
+: n(new NTL::ZZ(*modulus.number)),
+  nPrime(new NTL::ZZ(0)),
+  r2(new NTL::ZZ(0)),
+  k(((NTL::NumBits(*modulus.number) + 2 + 63) / 64) * 64),
+  odd(NTL::bit(*modulus.number, 0) == 1 && *modulus.number > 0),
+  limbs((NTL::NumBits(*modulus.number) + 63) / 64),
+  words(0),
+  n0(0) {
+
+    if (odd) {
+        NTL::ZZ R;
+        NTL::LeftShift(R, NTL::ZZ(1), k);
+        NTL::InvMod(*nPrime, *n, R);
+        NTL::sub(*nPrime, R, *nPrime);
+        NTL::LeftShift(*r2, NTL::ZZ(1), 2 * k);
+        NTL::rem(*r2, *r2, *n);
+
+        // Wider moduli stay with NTL, whose subquadratic multiplication
+        // is faster than the fixed width kernel from 32 limbs up.
+        switch (limbs) {
+            case 16:
+            case 24:
+                NTL::LeftShift(R, NTL::ZZ(1), 2 * 64 * limbs);
+                NTL::rem(R, R, *n);
+                words = new uint64_t[limbs * 2];
+                toWords(words, *n, limbs);
+                toWords(words + limbs, R, limbs);
+                toWords(&n0, *nPrime, 1);
+                break;
+        }
+    }
+
+}
+
+MontgomeryContext::MontgomeryContext(const MontgomeryContext& other)
+: n(new NTL::ZZ(*other.n)),
+  nPrime(new NTL::ZZ(*other.nPrime)),
+  r2(new NTL::ZZ(*other.r2)),
+  k(other.k),
+  odd(other.odd),
+  limbs(other.limbs),
+  words(0),
+  n0(other.n0) {
+
+    if (other.words != 0) {
+        words = new uint64_t[limbs * 2];
+        memcpy(words, other.words, limbs * 2 * sizeof(uint64_t));
+    }
+
+}
+
+MontgomeryContext& MontgomeryContext::operator= (const MontgomeryContext& other) {
+
+    *n = *other.n;
+    *nPrime = *other.nPrime;
+    *r2 = *other.r2;
+    k = other.k;
+    odd = other.odd;
+    if (words != other.words) {
+        delete[] words;
+        words = 0;
+        if (other.words != 0) {
+            words = new uint64_t[other.limbs * 2];
+            memcpy(words, other.words, other.limbs * 2 * sizeof(uint64_t));
+        }
+    }
+    limbs = other.limbs;
+    n0 = other.n0;
+    return *this;
+
+}
+
+MontgomeryContext::~MontgomeryContext() {
+
+    delete[] words;
+    delete r2;
+    delete nPrime;
+    delete n;
+
+}
+
+/*
+ * Returns base^exp mod n.
+ */
+BigInteger MontgomeryContext::modPow(const BigInteger& base, const BigInteger& exp) const {
+
+    Integers results(modPow(Integers(1, base), exp));
+    return results.front();
+
+}
+
+/*
+ * Returns base^exp mod n for each base. The exponent and the fixed
+ * width modulus are converted once for the whole batch.
+ */
+MontgomeryContext::Integers MontgomeryContext::modPow(const Integers& bases,
+                                                    const BigInteger& exp) const {
+
+    Integers results;
+    if (!odd || exp < BigInteger::ZERO) {
+        for (unsigned i = 0; i < bases.size(); ++i) {
+            results.push_back(bases[i].modPow(exp, BigInteger(*n)));
+        }
+        return results;
+    }
+
+    if (words != 0 && NTL::NumBits(*exp.number) <= long(limbs * 64)) {
+        switch (limbs) {
+            case 16:
+                fixedModPow<16>(bases, exp, results);
+                return results;
+            case 24:
+                fixedModPow<24>(bases, exp, results);
+                return results;
+        }
+    }
+
+    for (unsigned i = 0; i < bases.size(); ++i) {
+        results.push_back(ntlModPow(bases[i], exp));
+    }
+    return results;
+
+}
+
+/*
+ * The base and a table of its powers are moved into Montgomery form
+ * and the exponent is scanned from the top, a fixed width window at a
+ * time. Large exponents, which are private, get a window of 4 or 5
+ * bits and a multiplication for every window whether it's zero or
+ * not. The table entry for the window is found by a masked scan of
+ * every entry, as FixedMontgomery does it, so the memory accesses don't
+ * depend on the window. Exponents of 64 bits or less are taken to be
+ * public and are done a bit at a time, skipping the zero bits.
+ *
+ * Values stay below 2n, and are only reduced below n at the end.
+ */
+BigInteger MontgomeryContext::ntlModPow(const BigInteger& base, const BigInteger& exp) const {
+
+    const NTL::ZZ& e(*exp.number);
+    long bits = NTL::NumBits(e);
+    long w = bits > 512 ? 5 : (bits > 64 ? 4 : 1);
+
+    NTL::ZZ t;
+    NTL::ZZ m;
+    NTL::ZZ x;
+    const NTL::ZZ one(1);
+    std::vector<NTL::ZZ> table(1 << w);
+    NTL::rem(x, *base.number, *n);
+    multiply(table[0], one, *r2, t, m);
+    multiply(table[1], x, *r2, t, m);
+    for (unsigned i = 2; i < table.size(); ++i) {
+        multiply(table[i], table[i - 1], table[1], t, m);
+    }
+
+    // The table as k bit words for the masked scan.
+    unsigned count = k / 64;
+    std::vector<uint64_t> entries;
+    std::vector<uint64_t> entry(count);
+    if (w > 1) {
+        entries.resize(table.size() * count);
+        for (unsigned i = 0; i < table.size(); ++i) {
+            toWords(&entries[i * count], table[i], count);
+        }
+    }
+
+    NTL::ZZ result(table[0]);
+    NTL::ZZ selected;
+    for (long i = ((bits + w - 1) / w) * w - w; i >= 0; i -= w) {
+        for (long j = 0; j < w; ++j) {
+            multiply(result, result, result, t, m);
+        }
+        unsigned window = 0;
+        for (long j = w - 1; j >= 0; --j) {
+            window = (window << 1) | NTL::bit(e, i + j);
+        }
+        if (w > 1) {
+            for (unsigned j = 0; j < table.size(); ++j) {
+                uint64_t d = j ^ window;
+                uint64_t mask = ((d | (0 - d)) >> 63) - 1;
+                const uint64_t *from = &entries[j * count];
+                for (unsigned l = 0; l < count; ++l) {
+                    entry[l] = (entry[l] & ~mask) | (from[l] & mask);
+                }
+            }
+            fromWords(selected, &entry[0], count);
+            multiply(result, result, selected, t, m);
+        }
+        else if (window != 0) {
+            multiply(result, result, table[1], t, m);
+        }
+    }
+
+    if (entries.size() != 0) {
+        memset(&entries[0], 0, entries.size() * sizeof(uint64_t));
+    }
+    memset(&entry[0], 0, entry.size() * sizeof(uint64_t));
+
+    // Multiplying by 1 takes the result out of Montgomery form. That
+    // leaves it at most n, and n only for a base that is a multiple of n.
+    multiply(x, result, one, t, m);
+    NTL::rem(x, x, *n);
+    return BigInteger(x);
+
+}
+
+/*
+ * modPow with N limb values on the stack. The exponent must fit in N
+ * limbs.
+ */
+template<unsigned N>
+void MontgomeryContext::fixedModPow(const Integers& bases, const BigInteger& exp,
+                                                    Integers& results) const {
+
+    uint64_t w[N];
+    toWords(w, *exp.number, N);
+    FixedInteger<N> e(w);
+    FixedMontgomery<N> mont(FixedInteger<N>(words), FixedInteger<N>(words + N), n0);
+
+    NTL::ZZ x;
+    for (unsigned i = 0; i < bases.size(); ++i) {
+        NTL::rem(x, *bases[i].number, *n);
+        toWords(w, x, N);
+        FixedInteger<N> result(w);
+        mont.modPow(result, result, e);
+        result.getWords(w);
+        fromWords(x, w, N);
+        results.push_back(BigInteger(x));
+    }
+    memset(w, 0, sizeof(w));
+    e.clear();
+
+}
+
+/*
+ * x = a * b * R^-1 mod n, for a and b less than 2n.
+ *
+ * m = (ab mod R) * n' mod R
+ * x = (ab + mn) / R
+ *
+ * Because R > 4n, x is less than 2n without subtracting n. There is no
+ * comparison of x with n, so nothing branches on the value.
+ *
+ * t and m are scratch. x may be a or b.
+ */
+void MontgomeryContext::multiply(NTL::ZZ& x, const NTL::ZZ& a, const NTL::ZZ& b,
+                                            NTL::ZZ& t, NTL::ZZ& m) const {
+
+    NTL::mul(t, a, b);
+    NTL::trunc(m, t, k);
+    NTL::mul(m, m, *nPrime);
+    NTL::trunc(m, m, k);
+    NTL::mul(m, m, *n);
+    NTL::add(t, t, m);
+    NTL::RightShift(x, t, k);
+
+}
+
+}
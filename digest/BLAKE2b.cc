@@ -0,0 +1,171 @@
+#include "digest/BLAKE2b.h"
+#include "exceptions/BadParameterException.h"
+#include <string.h>
+
+namespace CK {
+
+// Static initializers
+const uint64_t BLAKE2b::IV[8] =
+{ 0x6a09e667f3bcc908L, 0xbb67ae8584caa73bL, 0x3c6ef372fe94f82bL, 0xa54ff53a5f1d36f1L,
+  0x510e527fade682d1L, 0x9b05688c2b3e6c1fL, 0x1f83d9abfb41bd6bL, 0x5be0cd19137e2179L };
+
+const uint8_t BLAKE2b::SIGMA[10][16] =
+{ { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 },
+  { 14, 10, 4, 8, 9, 15, 13, 6, 1, 12, 0, 2, 11, 7, 5, 3 },
+  { 11, 8, 12, 0, 5, 2, 15, 13, 10, 14, 3, 6, 7, 1, 9, 4 },
+  { 7, 9, 3, 1, 13, 12, 11, 14, 2, 6, 5, 10, 4, 0, 15, 8 },
+  { 9, 0, 5, 7, 2, 4, 10, 15, 14, 1, 11, 12, 6, 8, 3, 13 },
+  { 2, 12, 6, 10, 0, 11, 8, 3, 4, 13, 7, 5, 15, 14, 1, 9 },
+  { 12, 5, 1, 15, 14, 13, 4, 10, 0, 7, 6, 3, 9, 2, 8, 11 },
+  { 13, 11, 7, 14, 12, 1, 3, 9, 5, 0, 15, 4, 8, 6, 2, 10 },
+  { 6, 15, 14, 9, 11, 3, 0, 8, 12, 2, 13, 7, 1, 4, 10, 5 },
+  { 10, 2, 8, 4, 7, 6, 1, 5, 15, 11, 9, 14, 3, 12, 13, 0 } };
+
+const coder::ByteArray BLAKE2b::DER;
+
+BLAKE2b::BLAKE2b(unsigned len)
+: DigestBase(128),
+  length(len) {
+
+    if (length == 0 || length > 64) {
+        throw BadParameterException("Invalid BLAKE2b digest length");
+    }
+    reset();
+
+}
+
+BLAKE2b::~BLAKE2b() {
+}
+
+/*
+ * Return a new digest with a copy of the current state.
+ */
+Digest *BLAKE2b::clone() const {
+
+    BLAKE2b *copy = new BLAKE2b(length);
+    copy->restoreState(*this);
+    return copy;
+
+}
+
+/*
+ * Process one 1024 bit block. The last block is held back by the
+ * base class and processed in finalize.
+ */
+void BLAKE2b::compress(const uint8_t *chunk) {
+
+    t += 128;
+    mix(chunk, false);
+
+}
+
+/*
+ * Copy the hash state of another BLAKE2b.
+ */
+void BLAKE2b::copyState(const DigestBase& other) {
+
+    const BLAKE2b& o = static_cast<const BLAKE2b&>(other);
+    if (o.length != length) {
+        throw BadParameterException("Digest state length mismatch");
+    }
+    memcpy(H, o.H, sizeof(H));
+    t = o.t;
+
+}
+
+/*
+ * Process the last block and store the hash value. The block is
+ * zero padded and flagged as last. There is no length padding.
+ */
+void BLAKE2b::finalize(uint8_t *out) {
+
+    unsigned count;
+    const uint8_t *last = lastChunk(count);
+    t += count;
+    mix(last, true);
+
+    for (unsigned i = 0; i < length; ++i) {
+        out[i] = (H[i / 8] >> ((i % 8) * 8)) & 0xff;
+    }
+
+}
+
+/*
+ * Mixing function G.
+ */
+void BLAKE2b::G(uint64_t *v, int a, int b, int c, int d, uint64_t x, uint64_t y) const {
+
+    v[a] = v[a] + v[b] + x;
+    v[d] = ror(v[d] ^ v[a], 32);
+    v[c] = v[c] + v[d];
+    v[b] = ror(v[b] ^ v[c], 24);
+    v[a] = v[a] + v[b] + y;
+    v[d] = ror(v[d] ^ v[a], 16);
+    v[c] = v[c] + v[d];
+    v[b] = ror(v[b] ^ v[c], 63);
+
+}
+
+/*
+ * Set the initial hash state. The parameter block is folded into
+ * the first word: digest length, no key, fanout and depth 1.
+ */
+void BLAKE2b::initialize() {
+
+    memcpy(H, IV, sizeof(H));
+    H[0] ^= 0x01010000 ^ length;
+    t = 0;
+
+}
+
+/*
+ * Compression function F. 12 rounds of G over the columns and
+ * diagonals of the work vector.
+ */
+void BLAKE2b::mix(const uint8_t *block, bool last) {
+
+    uint64_t m[16];
+    for (int j = 0; j < 16; ++j) {
+        const uint8_t *p = block + (j * 8);
+        m[j] = uint64_t(p[0]) | (uint64_t(p[1]) << 8)
+                | (uint64_t(p[2]) << 16) | (uint64_t(p[3]) << 24)
+                | (uint64_t(p[4]) << 32) | (uint64_t(p[5]) << 40)
+                | (uint64_t(p[6]) << 48) | (uint64_t(p[7]) << 56);
+    }
+
+    uint64_t v[16];
+    memcpy(v, H, sizeof(H));
+    memcpy(v + 8, IV, sizeof(IV));
+    v[12] ^= t;
+    if (last) {
+        v[14] = ~v[14];
+    }
+
+    for (int r = 0; r < 12; ++r) {
+        const uint8_t *s = SIGMA[r % 10];
+        G(v, 0, 4, 8, 12, m[s[0]], m[s[1]]);
+        G(v, 1, 5, 9, 13, m[s[2]], m[s[3]]);
+        G(v, 2, 6, 10, 14, m[s[4]], m[s[5]]);
+        G(v, 3, 7, 11, 15, m[s[6]], m[s[7]]);
+        G(v, 0, 5, 10, 15, m[s[8]], m[s[9]]);
+        G(v, 1, 6, 11, 12, m[s[10]], m[s[11]]);
+        G(v, 2, 7, 8, 13, m[s[12]], m[s[13]]);
+        G(v, 3, 4, 9, 14, m[s[14]], m[s[15]]);
+    }
+
+    for (int i = 0; i < 8; ++i) {
+        H[i] ^= v[i] ^ v[i + 8];
+    }
+
+}
+
+/*
+ * Logical rotate right function.
+ */
+uint64_t BLAKE2b::ror(uint64_t reg, int count) const {
+
+    return (reg >> count) | (reg << (64 - count));
+
+}
+
+}
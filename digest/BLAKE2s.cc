@@ -0,0 +1,170 @@
+#include "digest/BLAKE2s.h"
+#include "exceptions/BadParameterException.h"
+#include <string.h>
+
+namespace CK {
+
+// Static initializers
+const uint32_t BLAKE2s::IV[8] =
+{ 0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+  0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19 };
+
+const uint8_t BLAKE2s::SIGMA[10][16] =
+{ { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 },
+  { 14, 10, 4, 8, 9, 15, 13, 6, 1, 12, 0, 2, 11, 7, 5, 3 },
+  { 11, 8, 12, 0, 5, 2, 15, 13, 10, 14, 3, 6, 7, 1, 9, 4 },
+  { 7, 9, 3, 1, 13, 12, 11, 14, 2, 6, 5, 10, 4, 0, 15, 8 },
+  { 9, 0, 5, 7, 2, 4, 10, 15, 14, 1, 11, 12, 6, 8, 3, 13 },
+  { 2, 12, 6, 10, 0, 11, 8, 3, 4, 13, 7, 5, 15, 14, 1, 9 },
+  { 12, 5, 1, 15, 14, 13, 4, 10, 0, 7, 6, 3, 9, 2, 8, 11 },
+  { 13, 11, 7, 14, 12, 1, 3, 9, 5, 0, 15, 4, 8, 6, 2, 10 },
+  { 6, 15, 14, 9, 11, 3, 0, 8, 12, 2, 13, 7, 1, 4, 10, 5 },
+  { 10, 2, 8, 4, 7, 6, 1, 5, 15, 11, 9, 14, 3, 12, 13, 0 } };
+
+const coder::ByteArray BLAKE2s::DER;
+
+BLAKE2s::BLAKE2s(unsigned len)
+: DigestBase(64),
+  length(len) {
+
+    if (length == 0 || length > 32) {
+        throw BadParameterException("Invalid BLAKE2s digest length");
+    }
+    reset();
+
+}
+
+BLAKE2s::~BLAKE2s() {
+}
+
+/*
+ * Return a new digest with a copy of the current state.
+ */
+Digest *BLAKE2s::clone() const {
+
+    BLAKE2s *copy = new BLAKE2s(length);
+    copy->restoreState(*this);
+    return copy;
+
+}
+
+/*
+ * Process one 512 bit block. The last block is held back by the
+ * base class and processed in finalize.
+ */
+void BLAKE2s::compress(const uint8_t *chunk) {
+
+    t += 64;
+    mix(chunk, false);
+
+}
+
+/*
+ * Copy the hash state of another BLAKE2s.
+ */
+void BLAKE2s::copyState(const DigestBase& other) {
+
+    const BLAKE2s& o = static_cast<const BLAKE2s&>(other);
+    if (o.length != length) {
+        throw BadParameterException("Digest state length mismatch");
+    }
+    memcpy(H, o.H, sizeof(H));
+    t = o.t;
+
+}
+
+/*
+ * Process the last block and store the hash value. The block is
+ * zero padded and flagged as last. There is no length padding.
+ */
+void BLAKE2s::finalize(uint8_t *out) {
+
+    unsigned count;
+    const uint8_t *last = lastChunk(count);
+    t += count;
+    mix(last, true);
+
+    for (unsigned i = 0; i < length; ++i) {
+        out[i] = (H[i / 4] >> ((i % 4) * 8)) & 0xff;
+    }
+
+}
+
+/*
+ * Mixing function G.
+ */
+void BLAKE2s::G(uint32_t *v, int a, int b, int c, int d, uint32_t x, uint32_t y) const {
+
+    v[a] = v[a] + v[b] + x;
+    v[d] = ror(v[d] ^ v[a], 16);
+    v[c] = v[c] + v[d];
+    v[b] = ror(v[b] ^ v[c], 12);
+    v[a] = v[a] + v[b] + y;
+    v[d] = ror(v[d] ^ v[a], 8);
+    v[c] = v[c] + v[d];
+    v[b] = ror(v[b] ^ v[c], 7);
+
+}
+
+/*
+ * Set the initial hash state. The parameter block is folded into
+ * the first word: digest length, no key, fanout and depth 1.
+ */
+void BLAKE2s::initialize() {
+
+    memcpy(H, IV, sizeof(H));
+    H[0] ^= 0x01010000 ^ length;
+    t = 0;
+
+}
+
+/*
+ * Compression function F. 10 rounds of G over the columns and
+ * diagonals of the work vector.
+ */
+void BLAKE2s::mix(const uint8_t *block, bool last) {
+
+    uint32_t m[16];
+    for (int j = 0; j < 16; ++j) {
+        const uint8_t *p = block + (j * 4);
+        m[j] = uint32_t(p[0]) | (uint32_t(p[1]) << 8)
+                | (uint32_t(p[2]) << 16) | (uint32_t(p[3]) << 24);
+    }
+
+    uint32_t v[16];
+    memcpy(v, H, sizeof(H));
+    memcpy(v + 8, IV, sizeof(IV));
+    v[12] ^= uint32_t(t);
+    v[13] ^= uint32_t(t >> 32);
+    if (last) {
+        v[14] = ~v[14];
+    }
+
+    for (int r = 0; r < 10; ++r) {
+        const uint8_t *s = SIGMA[r];
+        G(v, 0, 4, 8, 12, m[s[0]], m[s[1]]);
+        G(v, 1, 5, 9, 13, m[s[2]], m[s[3]]);
+        G(v, 2, 6, 10, 14, m[s[4]], m[s[5]]);
+        G(v, 3, 7, 11, 15, m[s[6]], m[s[7]]);
+        G(v, 0, 5, 10, 15, m[s[8]], m[s[9]]);
+        G(v, 1, 6, 11, 12, m[s[10]], m[s[11]]);
+        G(v, 2, 7, 8, 13, m[s[12]], m[s[13]]);
+        G(v, 3, 4, 9, 14, m[s[14]], m[s[15]]);
+    }
+
+    for (int i = 0; i < 8; ++i) {
+        H[i] ^= v[i] ^ v[i + 8];
+    }
+
+}
+
+/*
+ * Logical rotate right function.
+ */
+uint32_t BLAKE2s::ror(uint32_t reg, int count) const {
+
+    return (reg >> count) | (reg << (32 - count));
+
+}
+
+}
@@ -0,0 +1,699 @@
+#include "digest/BLAKE3.h"
+#include "data/CPUFeatures.h"
+#include "data/MappedFile.h"
+#include "exceptions/BadParameterException.h"
+#include <algorithm>
+#include <exception>
+#include <memory>
+#include <thread>
+#include <typeinfo>
+#include <vector>
+#include <string.h>
+
+namespace CK {
+
+// Static initializers
+const uint32_t BLAKE3::IV[8] =
+{ 0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+  0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19 };
+
+const uint8_t BLAKE3::SCHEDULE[7][16] =
+{ { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 },
+  { 2, 6, 3, 10, 7, 0, 4, 13, 1, 11, 12, 5, 9, 14, 15, 8 },
+  { 3, 4, 10, 12, 13, 2, 7, 14, 6, 5, 9, 0, 11, 15, 8, 1 },
+  { 10, 7, 12, 9, 14, 3, 13, 15, 4, 0, 11, 2, 5, 8, 1, 6 },
+  { 12, 13, 9, 11, 15, 10, 14, 8, 7, 2, 5, 3, 0, 1, 6, 4 },
+  { 9, 14, 11, 5, 8, 12, 15, 1, 13, 3, 0, 10, 2, 6, 4, 7 },
+  { 11, 15, 5, 0, 1, 9, 8, 6, 14, 10, 2, 12, 3, 4, 7, 13 } };
+
+const coder::ByteArray BLAKE3::DER;
+
+/*
+ * Little endian word load.
+ */
+inline uint32_t load32(const uint8_t *p) {
+
+    return uint32_t(p[0]) | (uint32_t(p[1]) << 8)
+            | (uint32_t(p[2]) << 16) | (uint32_t(p[3]) << 24);
+
+}
+
+/*
+ * SIMD lanes are written with the GCC/Clang vector extensions, as in
+ * SHA256Batch. One lane hashes one chunk.
+ */
+typedef uint32_t Lanes4 __attribute__((vector_size(16)));
+typedef uint32_t Lanes8 __attribute__((vector_size(32)));
+typedef uint32_t Lanes16 __attribute__((vector_size(64)));
+
+#define LANE_ROR(x, count) (((x) >> (count)) | ((x) << (32 - (count))))
+
+/*
+ * The G function. Used for scalar words and lane vectors.
+ */
+template <typename V> inline __attribute__((always_inline))
+void mixG(V& a, V& b, V& c, V& d, const V& x, const V& y) {
+
+    a = a + b + x;
+    d = LANE_ROR(d ^ a, 16);
+    c = c + d;
+    b = LANE_ROR(b ^ c, 12);
+    a = a + b + y;
+    d = LANE_ROR(d ^ a, 8);
+    c = c + d;
+    b = LANE_ROR(b ^ c, 7);
+
+}
+
+#undef LANE_ROR
+
+/*
+ * Seven rounds of G over the columns and diagonals of v.
+ */
+template <typename V> inline __attribute__((always_inline))
+void mixRounds(V *v, const V *m, const uint8_t (*S)[16]) {
+
+    for (int r = 0; r < 7; ++r) {
+        const uint8_t *s = S[r];
+        mixG(v[0], v[4], v[8], v[12], m[s[0]], m[s[1]]);
+        mixG(v[1], v[5], v[9], v[13], m[s[2]], m[s[3]]);
+        mixG(v[2], v[6], v[10], v[14], m[s[4]], m[s[5]]);
+        mixG(v[3], v[7], v[11], v[15], m[s[6]], m[s[7]]);
+        mixG(v[0], v[5], v[10], v[15], m[s[8]], m[s[9]]);
+        mixG(v[1], v[6], v[11], v[12], m[s[10]], m[s[11]]);
+        mixG(v[2], v[7], v[8], v[13], m[s[12]], m[s[13]]);
+        mixG(v[3], v[4], v[9], v[14], m[s[14]], m[s[15]]);
+    }
+
+}
+
+/*
+ * Hash consecutive whole chunks, one per lane of V, to their
+ * chaining values. Lane i hashes the chunk at chunks + i * 1024 with
+ * chunk counter counter + i.
+ */
+template <typename V> inline __attribute__((always_inline))
+void laneChunks(const uint8_t *chunks, uint64_t counter, uint32_t (&cvs)[8][16],
+                                    const uint32_t *IV, const uint8_t (*S)[16]) {
+
+    const unsigned N = sizeof(V) / sizeof(uint32_t);
+    const V zero = {};
+
+    uint32_t low[16];
+    uint32_t high[16];
+    for (unsigned i = 0; i < N; ++i) {
+        low[i] = uint32_t(counter + i);
+        high[i] = uint32_t((counter + i) >> 32);
+    }
+    V counterLow;
+    V counterHigh;
+    memcpy(&counterLow, low, sizeof(V));
+    memcpy(&counterHigh, high, sizeof(V));
+
+    V h[8];
+    for (int i = 0; i < 8; ++i) {
+        h[i] = zero + IV[i];
+    }
+
+    for (int b = 0; b < 16; ++b) {
+        uint32_t words[16][16];
+        for (int j = 0; j < 16; ++j) {
+            for (unsigned i = 0; i < N; ++i) {
+                words[j][i] = load32(chunks + (i * 1024) + (b * 64) + (j * 4));
+            }
+        }
+        V m[16];
+        for (int j = 0; j < 16; ++j) {
+            memcpy(&m[j], words[j], sizeof(V));
+        }
+
+        uint32_t flags = (b == 0 ? 1 : 0) | (b == 15 ? 2 : 0);
+        V v[16];
+        for (int i = 0; i < 8; ++i) {
+            v[i] = h[i];
+        }
+        for (int i = 0; i < 4; ++i) {
+            v[i + 8] = zero + IV[i];
+        }
+        v[12] = counterLow;
+        v[13] = counterHigh;
+        v[14] = zero + 64U;
+        v[15] = zero + flags;
+
+        mixRounds(v, m, S);
+
+        for (int i = 0; i < 8; ++i) {
+            h[i] = v[i] ^ v[i + 8];
+        }
+    }
+
+    for (int i = 0; i < 8; ++i) {
+        memcpy(cvs[i], &h[i], sizeof(V));
+    }
+
+}
+
+void BLAKE3::hash4(const uint8_t *chunks, uint64_t counter, LaneCV& cvs) {
+
+    laneChunks<Lanes4>(chunks, counter, cvs, IV, SCHEDULE);
+
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+__attribute__((target("avx2")))
+void BLAKE3::hash8(const uint8_t *chunks, uint64_t counter, LaneCV& cvs) {
+
+    laneChunks<Lanes8>(chunks, counter, cvs, IV, SCHEDULE);
+
+}
+
+__attribute__((target("avx512f")))
+void BLAKE3::hash16(const uint8_t *chunks, uint64_t counter, LaneCV& cvs) {
+
+    laneChunks<Lanes16>(chunks, counter, cvs, IV, SCHEDULE);
+
+}
+#endif
+
+BLAKE3::BLAKE3(unsigned len)
+: length(len),
+  threads(0),
+  lanes(4),
+  kernel(hash4) {
+
+    if (length == 0) {
+        throw BadParameterException("Invalid BLAKE3 digest length");
+    }
+
+#if defined(__x86_64__) || defined(__i386__)
+    if (CPUFeatures::hasAVX512()) {
+        lanes = 16;
+        kernel = hash16;
+    }
+    else if (CPUFeatures::hasAVX2()) {
+        lanes = 8;
+        kernel = hash8;
+    }
+#endif
+
+    setThreads(0);
+    reset();
+
+}
+
+BLAKE3::~BLAKE3() {
+}
+
+/*
+ * Hash one whole chunk that isn't the root.
+ */
+void BLAKE3::chunkCV(const uint8_t *chunk, uint64_t counter, uint32_t *cv) {
+
+    uint32_t h[16];
+    memcpy(h, IV, sizeof(IV));
+    for (int b = 0; b < 16; ++b) {
+        uint32_t m[16];
+        for (int j = 0; j < 16; ++j) {
+            m[j] = load32(chunk + (b * 64) + (j * 4));
+        }
+        uint32_t flags = (b == 0 ? CHUNK_START : 0) | (b == 15 ? CHUNK_END : 0);
+        compress(h, m, counter, 64, flags, h);
+    }
+    memcpy(cv, h, 32);
+
+}
+
+/*
+ * Set up the last compression of the current chunk.
+ */
+void BLAKE3::chunkOutput(Output& out) const {
+
+    uint8_t last[64];
+    memcpy(last, block, blockLen);
+    memset(last + blockLen, 0, 64 - blockLen);
+
+    memcpy(out.cv, cv, sizeof(cv));
+    for (int j = 0; j < 16; ++j) {
+        out.block[j] = load32(last + (j * 4));
+    }
+    out.counter = chunkCounter;
+    out.blockLen = blockLen;
+    out.flags = (blocksCompressed == 0 ? CHUNK_START : 0) | CHUNK_END;
+
+}
+
+/*
+ * Add bytes to the current chunk. A full block is compressed only
+ * when more bytes arrive, so the last block of the chunk is always
+ * still buffered.
+ */
+void BLAKE3::chunkUpdate(const uint8_t *bytes, unsigned count) {
+
+    while (count > 0) {
+        if (blockLen == 64) {
+            uint32_t m[16];
+            for (int j = 0; j < 16; ++j) {
+                m[j] = load32(block + (j * 4));
+            }
+            uint32_t out[16];
+            compress(cv, m, chunkCounter, 64, blocksCompressed == 0 ? CHUNK_START : 0, out);
+            memcpy(cv, out, sizeof(cv));
+            blocksCompressed++;
+            blockLen = 0;
+        }
+        unsigned take = std::min(64 - blockLen, count);
+        memcpy(block + blockLen, bytes, take);
+        blockLen += take;
+        bytes += take;
+        count -= take;
+    }
+
+}
+
+/*
+ * Return a new digest with a copy of the current state.
+ */
+Digest *BLAKE3::clone() const {
+
+    BLAKE3 *copy = new BLAKE3(length);
+    copy->setThreads(threads);
+    copy->restoreState(*this);
+    return copy;
+
+}
+
+/*
+ * The compression function. out may be the same array as cv. The
+ * first 8 words of out are the chaining value, all 16 are used for
+ * root output.
+ */
+void BLAKE3::compress(const uint32_t *cv, const uint32_t *block, uint64_t counter,
+                                uint32_t blockLen, uint32_t flags, uint32_t *out) {
+
+    uint32_t v[16];
+    memcpy(v, cv, 32);
+    memcpy(v + 8, IV, 16);
+    v[12] = uint32_t(counter);
+    v[13] = uint32_t(counter >> 32);
+    v[14] = blockLen;
+    v[15] = flags;
+
+    mixRounds(v, block, SCHEDULE);
+
+    for (int i = 0; i < 8; ++i) {
+        out[i + 8] = v[i + 8] ^ cv[i];
+        out[i] = v[i] ^ v[i + 8];
+    }
+
+}
+
+/*
+ * Complete the digest.
+ */
+coder::ByteArray BLAKE3::digest() {
+
+    if (length <= 64) {
+        uint8_t d[64];
+        digest(d);
+        return coder::ByteArray(d, length);
+    }
+
+    std::unique_ptr<uint8_t[]> d(new uint8_t[length]);
+    digest(d.get());
+    return coder::ByteArray(d.get(), length);
+
+}
+
+/*
+ * Complete the digest into a caller buffer. The current chunk is
+ * merged up through the subtree stack and the root node is expanded
+ * to the digest length.
+ */
+void BLAKE3::digest(uint8_t *out) {
+
+    // A single chunk is the root. Otherwise the chunk holds at least
+    // one byte, since whole chunks are only retired when more input
+    // arrives.
+    Output root;
+    chunkOutput(root);
+    mergeStack(chunkCounter);
+    for (unsigned i = stackSize; i > 0; --i) {
+        uint32_t out[16];
+        compress(root.cv, root.block, root.counter, root.blockLen, root.flags, out);
+        memcpy(root.cv, IV, sizeof(IV));
+        memcpy(root.block, stack[i - 1], 32);
+        memcpy(root.block + 8, out, 32);
+        root.counter = 0;
+        root.blockLen = 64;
+        root.flags = PARENT;
+    }
+
+    for (uint64_t n = 0; n * 64 < length; ++n) {
+        uint32_t words[16];
+        compress(root.cv, root.block, n, root.blockLen, root.flags | ROOT, words);
+        for (unsigned i = 0; i < 64 && (n * 64) + i < length; ++i) {
+            out[(n * 64) + i] = (words[i / 4] >> ((i % 4) * 8)) & 0xff;
+        }
+    }
+
+    reset();
+
+}
+
+/*
+ * One step hash. Accumulated updates are lost.
+ */
+coder::ByteArray BLAKE3::digest(const coder::ByteArray& bytes) {
+
+    reset();
+    update(bytes);
+    return digest();
+
+}
+
+/*
+ * One step hash of a memory range. Accumulated updates are lost.
+ */
+coder::ByteArray BLAKE3::digest(const uint8_t *bytes, uint64_t count) {
+
+    reset();
+    update(bytes, count);
+    return digest();
+
+}
+
+/*
+ * One step hash of a file. Accumulated updates are lost.
+ *
+ * The file is memory mapped, so the whole file is one update and the
+ * threads hash straight from the mapped pages.
+ */
+coder::ByteArray BLAKE3::digestFile(const std::string& path) {
+
+    MappedFile file(path);
+    return digest(file.getData(), file.getLength());
+
+}
+
+/*
+ * Merge subtrees until the stack holds one entry per set bit of
+ * total, the number of chunks hashed so far. Merging is put off
+ * until the next chaining value arrives, so a subtree is never
+ * merged before it's known to be complete.
+ */
+void BLAKE3::mergeStack(uint64_t total) {
+
+    unsigned size = __builtin_popcountll(total);
+    while (stackSize > size) {
+        parentCV(stack[stackSize - 2], stack[stackSize - 1], stack[stackSize - 2]);
+        stackSize--;
+    }
+
+}
+
+/*
+ * Chaining value of a parent node. cv may be the same array as left.
+ */
+void BLAKE3::parentCV(const uint32_t *left, const uint32_t *right, uint32_t *cv) {
+
+    uint32_t m[16];
+    memcpy(m, left, 32);
+    memcpy(m + 8, right, 32);
+    uint32_t out[16];
+    compress(IV, m, 0, 64, PARENT, out);
+    memcpy(cv, out, 32);
+
+}
+
+/*
+ * Push the chaining value of a complete subtree. total is the number
+ * of chunks before the subtree.
+ */
+void BLAKE3::pushCV(const uint32_t *subtreeCV, uint64_t total) {
+
+    mergeStack(total);
+    memcpy(stack[stackSize++], subtreeCV, 32);
+
+}
+
+/*
+ * Clear the digest context.
+ */
+void BLAKE3::reset() {
+
+    memcpy(cv, IV, sizeof(IV));
+    chunkCounter = 0;
+    blockLen = 0;
+    blocksCompressed = 0;
+    stackSize = 0;
+
+}
+
+/*
+ * Restore the state saved in another BLAKE3 digest.
+ */
+void BLAKE3::restoreState(const Digest& snapshot) {
+
+    if (typeid(snapshot) != typeid(*this)) {
+        throw BadParameterException("Digest state algorithm mismatch");
+    }
+
+    const BLAKE3& other = static_cast<const BLAKE3&>(snapshot);
+    if (other.length != length) {
+        throw BadParameterException("Digest state length mismatch");
+    }
+    if (&other != this) {
+        memcpy(cv, other.cv, sizeof(cv));
+        chunkCounter = other.chunkCounter;
+        memcpy(block, other.block, sizeof(block));
+        blockLen = other.blockLen;
+        blocksCompressed = other.blocksCompressed;
+        memcpy(stack, other.stack, other.stackSize * 32);
+        stackSize = other.stackSize;
+    }
+
+}
+
+/*
+ * Save the current state in another BLAKE3 digest.
+ */
+void BLAKE3::saveState(Digest& snapshot) const {
+
+    snapshot.restoreState(*this);
+
+}
+
+/*
+ * Set the maximum number of hashing threads.
+ */
+void BLAKE3::setThreads(unsigned t) {
+
+    threads = t;
+    if (threads == 0) {
+        threads = std::max(1U, std::thread::hardware_concurrency());
+    }
+
+}
+
+/*
+ * Chaining value of a subtree of count whole chunks. count is a power
+ * of 2 and counter is a multiple of count.
+ *
+ * Large subtrees are split evenly between threads. The threads' own
+ * subtree chaining values are merged here.
+ */
+void BLAKE3::subtree(const uint8_t *chunks, uint64_t count, uint64_t counter,
+                                                        uint32_t *subtreeCV) const {
+
+    uint64_t workers = 1;
+    while (workers * 2 <= threads && count / (workers * 2) >= MIN_THREAD_CHUNKS) {
+        workers *= 2;
+    }
+    if (workers == 1) {
+        subtreeThread(chunks, count, counter, subtreeCV);
+        return;
+    }
+
+    uint64_t share = count / workers;
+    std::unique_ptr<uint32_t[][8]> cvs(new uint32_t[workers][8]);
+    // Threads that have started are always joined, and an exception on
+    // any thread is passed to the caller once they have been.
+    std::vector<std::exception_ptr> errors(workers);
+    std::vector<std::thread> pool;
+    pool.reserve(workers - 1);
+    try {
+        for (uint64_t w = 1; w < workers; ++w) {
+            uint32_t *out = cvs[w];
+            pool.push_back(std::thread([this, chunks, share, counter, w, out, &errors] {
+                try {
+                    subtreeThread(chunks + (w * share * CHUNK_LEN), share,
+                                                    counter + (w * share), out);
+                }
+                catch (...) {
+                    errors[w] = std::current_exception();
+                }
+            }));
+        }
+        subtreeThread(chunks, share, counter, cvs[0]);
+    }
+    catch (...) {
+        for (unsigned i = 0; i < pool.size(); ++i) {
+            pool[i].join();
+        }
+        throw;
+    }
+    for (unsigned i = 0; i < pool.size(); ++i) {
+        pool[i].join();
+    }
+    for (unsigned i = 0; i < errors.size(); ++i) {
+        if (errors[i]) {
+            std::rethrow_exception(errors[i]);
+        }
+    }
+
+    for (uint64_t width = workers; width > 1; width /= 2) {
+        for (uint64_t i = 0; i < width / 2; ++i) {
+            parentCV(cvs[2 * i], cvs[(2 * i) + 1], cvs[i]);
+        }
+    }
+    memcpy(subtreeCV, cvs[0], 32);
+
+}
+
+/*
+ * Chaining value of a subtree on the calling thread. Chunks are
+ * hashed a lane group at a time. Each group is merged to one chaining
+ * value and groups are merged on a local stack.
+ */
+void BLAKE3::subtreeThread(const uint8_t *chunks, uint64_t count, uint64_t counter,
+                                                        uint32_t *subtreeCV) const {
+
+    uint32_t local[MAX_DEPTH][8];
+    unsigned depth = 0;
+    uint64_t group = std::min(count, uint64_t(lanes));
+
+    for (uint64_t g = 0; g < count / group; ++g) {
+        const uint8_t *p = chunks + (g * group * CHUNK_LEN);
+        uint64_t c = counter + (g * group);
+        uint32_t level[MAX_LANES][8];
+        if (group == lanes) {
+            LaneCV laneCVs;
+            kernel(p, c, laneCVs);
+            for (unsigned i = 0; i < lanes; ++i) {
+                for (int j = 0; j < 8; ++j) {
+                    level[i][j] = laneCVs[j][i];
+                }
+            }
+        }
+        else {
+            for (unsigned i = 0; i < group; ++i) {
+                chunkCV(p + (i * CHUNK_LEN), c + i, level[i]);
+            }
+        }
+
+        for (uint64_t width = group; width > 1; width /= 2) {
+            for (uint64_t i = 0; i < width / 2; ++i) {
+                parentCV(level[2 * i], level[(2 * i) + 1], level[i]);
+            }
+        }
+
+        memcpy(local[depth++], level[0], 32);
+        for (uint64_t n = g + 1; (n & 1) == 0; n >>= 1) {
+            parentCV(local[depth - 2], local[depth - 1], local[depth - 2]);
+            depth--;
+        }
+    }
+
+    memcpy(subtreeCV, local[0], 32);
+
+}
+
+/*
+ * Update the digest context with a byte.
+ */
+void BLAKE3::update(uint8_t byte) {
+
+    update(&byte, 1);
+
+}
+
+/*
+ * Update the digest context with a byte array.
+ */
+void BLAKE3::update(const coder::ByteArray& bytes) {
+
+    update(bytes, 0, bytes.getLength());
+
+}
+
+/*
+ * Update the digest with a subrange of a message.
+ *
+ * The bytes are copied out of the array once. A range of up to one
+ * SIMD batch of chunks goes through a stack buffer. A longer range is
+ * copied to the heap whole, so its subtrees can still be split between
+ * threads.
+ */
+void BLAKE3::update(const coder::ByteArray& bytes, uint32_t offset, uint32_t count) {
+
+    uint8_t buffer[MAX_LANES * CHUNK_LEN];
+    std::unique_ptr<uint8_t[]> data(count > sizeof(buffer) ? new uint8_t[count] : 0);
+    uint8_t *copy = data ? data.get() : buffer;
+    for (uint32_t i = 0; i < count; ++i) {
+        copy[i] = bytes[offset + i];
+    }
+    update(copy, count);
+
+}
+
+/*
+ * Update the digest with a memory range.
+ *
+ * When the current chunk is empty and more than a chunk of input is
+ * left, the largest run of whole chunks that forms a complete subtree
+ * is hashed in one step. At least one byte is always left for the
+ * current chunk so the last chunk is never hashed early.
+ */
+void BLAKE3::update(const uint8_t *bytes, uint64_t count) {
+
+    while (count > 0) {
+        if ((blocksCompressed * 64) + blockLen == CHUNK_LEN) {
+            Output last;
+            chunkOutput(last);
+            uint32_t out[16];
+            compress(last.cv, last.block, last.counter, last.blockLen, last.flags, out);
+            pushCV(out, chunkCounter);
+            chunkCounter++;
+            memcpy(cv, IV, sizeof(IV));
+            blockLen = 0;
+            blocksCompressed = 0;
+        }
+
+        if (blocksCompressed == 0 && blockLen == 0 && count > CHUNK_LEN) {
+            uint64_t whole = (count - 1) / CHUNK_LEN;
+            uint64_t size = 1;
+            while (size * 2 <= whole) {
+                size *= 2;
+            }
+            while ((chunkCounter & (size - 1)) != 0) {
+                size /= 2;
+            }
+            uint32_t subtreeCV[8];
+            subtree(bytes, size, chunkCounter, subtreeCV);
+            pushCV(subtreeCV, chunkCounter);
+            chunkCounter += size;
+            bytes += size * CHUNK_LEN;
+            count -= size * CHUNK_LEN;
+        }
+        else {
+            unsigned filled = (blocksCompressed * 64) + blockLen;
+            unsigned take = std::min(uint64_t(CHUNK_LEN - filled), count);
+            chunkUpdate(bytes, take);
+            bytes += take;
+            count -= take;
+        }
+    }
+
+}
+
+}
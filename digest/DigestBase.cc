@@ -1,4 +1,22 @@
 #include "digest/DigestBase.h"
+#include "digest/BLAKE2b.h"
+#include "digest/BLAKE2s.h"
+#include "digest/BLAKE3.h"
+#include "digest/SHA1.h"
+#include "digest/SHA224.h"
+#include "digest/SHA256.h"
+#include "digest/SHA384.h"
+#include "digest/SHA512.h"
+#include "digest/SHA512_256.h"
+#include "digest/SHA3.h"
+#include "digest/SHAKE.h"
+#include "data/MappedFile.h"
+#include "exceptions/BadParameterException.h"
+#include "exceptions/NoSuchAlgorithmException.h"
+#include <algorithm>
+#include <memory>
+#include <typeinfo>
+#include <string.h>
 
 namespace CK {
 
@@ -7,20 +25,42 @@ namespace CK {
  * It is not intended to provide a functioning digest.
  */
 
-DigestBase::DigestBase() {
+DigestBase::DigestBase(unsigned cs)
+: messageLength(0),
+  chunkSize(cs),
+  fill(0) {
 }
 
 DigestBase::~DigestBase() {
 }
 
 /*
- * Complete a finalized digest.
+ * Complete a finalized digest. Fixed length digests are finalized on
+ * the stack, only a long SHAKE output needs a heap buffer.
  */
 coder::ByteArray DigestBase::digest() {
 
-    coder::ByteArray result = finalize(accumulator);
+    unsigned length = getDigestLength();
+    if (length <= MAX_DIGEST) {
+        uint8_t d[MAX_DIGEST];
+        digest(d);
+        return coder::ByteArray(d, length);
+    }
+
+    std::unique_ptr<uint8_t[]> d(new uint8_t[length]);
+    digest(d.get());
+    return coder::ByteArray(d.get(), length);
+
+}
+
+/*
+ * Complete a finalized digest into a caller buffer. Nothing is
+ * allocated.
+ */
+void DigestBase::digest(uint8_t *out) {
+
+    finalize(out);
     reset();
-    return result;
 
 }
 
@@ -29,9 +69,133 @@ coder::ByteArray DigestBase::digest() {
  */
 coder::ByteArray DigestBase::digest(const coder::ByteArray& bytes) {
 
-    coder::ByteArray result = finalize(bytes);
     reset();
-    return result;
+    update(bytes);
+    return digest();
+
+}
+
+/*
+ * One step hash of a file.
+ *
+ * The file is memory mapped and the mapped pages are compressed in
+ * place, so the file is never copied.
+ */
+coder::ByteArray DigestBase::digestFile(const std::string& path) {
+
+    MappedFile file(path);
+    reset();
+    update(file.getData(), file.getLength());
+    return digest();
+
+}
+
+/*
+ * Create a digest by name.
+ */
+Digest *DigestBase::getInstance(const std::string& algorithm) {
+
+    if (algorithm == "SHA-1") {
+        return new SHA1;
+    }
+    else if (algorithm == "SHA-224") {
+        return new SHA224;
+    }
+    else if (algorithm == "SHA-256") {
+        return new SHA256;
+    }
+    else if (algorithm == "SHA-384") {
+        return new SHA384;
+    }
+    else if (algorithm == "SHA-512") {
+        return new SHA512;
+    }
+    else if (algorithm == "SHA-512/256") {
+        return new SHA512_256;
+    }
+    else if (algorithm == "SHA3-224") {
+        return new SHA3(28);
+    }
+    else if (algorithm == "SHA3-256") {
+        return new SHA3(32);
+    }
+    else if (algorithm == "SHA3-384") {
+        return new SHA3(48);
+    }
+    else if (algorithm == "SHA3-512") {
+        return new SHA3(64);
+    }
+    else if (algorithm == "SHAKE128") {
+        return new SHAKE(128, 32);
+    }
+    else if (algorithm == "SHAKE256") {
+        return new SHAKE(256, 64);
+    }
+    else if (algorithm == "BLAKE2b") {
+        return new BLAKE2b;
+    }
+    else if (algorithm == "BLAKE2s") {
+        return new BLAKE2s;
+    }
+    else if (algorithm == "BLAKE3") {
+        return new BLAKE3;
+    }
+
+    throw NoSuchAlgorithmException(algorithm);
+
+}
+
+/*
+ * Return the buffered chunk without compressing it. count is set to
+ * the number of message bytes in the chunk and the rest of the chunk
+ * is zero filled. A full chunk is returned as is, for digests that
+ * flag the last block instead of padding.
+ */
+const uint8_t *DigestBase::lastChunk(unsigned& count) {
+
+    count = fill;
+    memset(chunk + fill, 0, chunkSize - fill);
+    fill = 0;
+    return chunk;
+
+}
+
+/*
+ * Pad the message.
+ *
+ * A single set bit is appended, followed by zeros until lengthSize
+ * bytes remain in the chunk. The message length in bits is encoded
+ * big endian in the remaining bytes. This may take one or two
+ * chunks.
+ */
+void DigestBase::pad(unsigned lengthSize) {
+
+    uint64_t bits = messageLength << 3;
+    uint64_t high = messageLength >> 61;
+
+    if (fill == chunkSize) {
+        compress(chunk);
+        fill = 0;
+    }
+    chunk[fill++] = 0x80;
+    if (fill > chunkSize - lengthSize) {
+        memset(chunk + fill, 0, chunkSize - fill);
+        compress(chunk);
+        fill = 0;
+    }
+    memset(chunk + fill, 0, chunkSize - fill);
+
+    unsigned end = chunkSize - 1;
+    for (int i = 0; i < 8; ++i) {
+        chunk[end - i] = (bits >> (i * 8)) & 0xff;
+    }
+    if (lengthSize > 8) {
+        for (int i = 0; i < 8; ++i) {
+            chunk[end - 8 - i] = (high >> (i * 8)) & 0xff;
+        }
+    }
+    compress(chunk);
+    fill = 0;
 
 }
 
@@ -40,7 +204,41 @@ coder::ByteArray DigestBase::digest(const coder::ByteArray& bytes) {
  */
 void DigestBase::reset() {
 
-    accumulator.clear();
+    fill = 0;
+    messageLength = 0;
+    initialize();
+
+}
+
+/*
+ * Restore the state saved in a digest of the same algorithm. The
+ * buffered partial chunk and the message length are copied along with
+ * the hash state.
+ */
+void DigestBase::restoreState(const Digest& snapshot) {
+
+    if (typeid(snapshot) != typeid(*this)) {
+        throw BadParameterException("Digest state algorithm mismatch");
+    }
+
+    if (&snapshot != this) {
+        // The subclass state goes first so size mismatches are
+        // caught before anything is changed.
+        const DigestBase& other = static_cast<const DigestBase&>(snapshot);
+        copyState(other);
+        messageLength = other.messageLength;
+        fill = other.fill;
+        memcpy(chunk, other.chunk, fill);
+    }
+
+}
+
+/*
+ * Save the current state in a digest of the same algorithm.
+ */
+void DigestBase::saveState(Digest& snapshot) const {
+
+    snapshot.restoreState(*this);
 
 }
 
@@ -49,7 +247,7 @@ void DigestBase::reset() {
  */
 void DigestBase::update(const coder::ByteArray& bytes) {
 
-    accumulator.append(bytes);
+    update(bytes, 0, bytes.getLength());
 
 }
 
@@ -58,18 +256,68 @@ void DigestBase::update(const coder::ByteArray& bytes) {
  */
 void DigestBase::update(unsigned char byte) {
 
-    accumulator.append(byte);
+    if (fill == chunkSize) {
+        compress(chunk);
+        fill = 0;
+    }
+    chunk[fill++] = byte;
+    messageLength++;
 
 }
 
 /*
  * Update the digest with a subrange of a message.
+ *
+ * A full chunk isn't compressed until more input arrives. Digests
+ * that treat the last chunk differently depend on that.
  */
 void DigestBase::update(const coder::ByteArray& bytes, unsigned offset, unsigned length) {
 
-    accumulator.append(bytes.range(offset, length));
+    messageLength += length;
+    while (length > 0) {
+        if (fill == chunkSize) {
+            compress(chunk);
+            fill = 0;
+        }
+        unsigned count = std::min(length, chunkSize - fill);
+        for (unsigned i = 0; i < count; ++i) {
+            chunk[fill + i] = bytes[offset + i];
+        }
+        fill += count;
+        offset += count;
+        length -= count;
+    }
 
 }
 
+/*
+ * Update the digest with a memory range.
+ *
+ * Whole chunks are compressed in place. Only a partial chunk, or the
+ * last whole chunk, is copied to the chunk buffer.
+ */
+void DigestBase::update(const uint8_t *bytes, uint64_t length) {
+
+    messageLength += length;
+    while (length > 0) {
+        if (fill == chunkSize) {
+            compress(chunk);
+            fill = 0;
+        }
+        if (fill == 0 && length > chunkSize) {
+            compress(bytes);
+            bytes += chunkSize;
+            length -= chunkSize;
+        }
+        else {
+            unsigned count = std::min(length, uint64_t(chunkSize - fill));
+            memcpy(chunk + fill, bytes, count);
+            fill += count;
+            bytes += count;
+            length -= count;
+        }
+    }
+
 }
 
+}
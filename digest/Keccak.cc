@@ -0,0 +1,244 @@
+#include "digest/Keccak.h"
+#include "exceptions/BadParameterException.h"
+#include <string.h>
+
+namespace CK {
+
+// Static initializers
+const uint64_t Keccak::RC[24] =
+{ 0x0000000000000001L, 0x0000000000008082L, 0x800000000000808aL, 0x8000000080008000L,
+  0x000000000000808bL, 0x0000000080000001L, 0x8000000080008081L, 0x8000000000008009L,
+  0x000000000000008aL, 0x0000000000000088L, 0x0000000080008009L, 0x000000008000000aL,
+  0x000000008000808bL, 0x800000000000008bL, 0x8000000000008089L, 0x8000000000008003L,
+  0x8000000000008002L, 0x8000000000000080L, 0x000000000000800aL, 0x800000008000000aL,
+  0x8000000080008081L, 0x8000000000008080L, 0x0000000080000001L, 0x8000000080008008L };
+
+const uint64_t Keccak::COMPLEMENT[25] =
+{ 0, ~0ULL, ~0ULL, 0, 0,
+  0, 0, 0, ~0ULL, 0,
+  0, 0, ~0ULL, 0, 0,
+  0, 0, ~0ULL, 0, 0,
+  ~0ULL, 0, 0, 0, 0 };
+
+Keccak::Keccak(unsigned r, uint8_t d)
+: DigestBase(r),
+  rate(r),
+  domain(d) {
+
+    reset();
+
+}
+
+Keccak::~Keccak() {
+}
+
+/*
+ * XOR one block into the state and permute.
+ */
+void Keccak::absorb(const uint8_t *block) {
+
+    for (unsigned i = 0; i < rate / 8; ++i) {
+        const uint8_t *p = block + (i * 8);
+        A[i] ^= uint64_t(p[0]) | (uint64_t(p[1]) << 8)
+                | (uint64_t(p[2]) << 16) | (uint64_t(p[3]) << 24)
+                | (uint64_t(p[4]) << 32) | (uint64_t(p[5]) << 40)
+                | (uint64_t(p[6]) << 48) | (uint64_t(p[7]) << 56);
+    }
+    permute();
+
+}
+
+/*
+ * Absorb one full block of input. Input that arrives after squeezing
+ * has started is dropped.
+ */
+void Keccak::compress(const uint8_t *chunk) {
+
+    if (!squeezing) {
+        absorb(chunk);
+    }
+
+}
+
+/*
+ * Copy the sponge state of another Keccak digest with the same rate
+ * and output length.
+ */
+void Keccak::copyState(const DigestBase& other) {
+
+    const Keccak& o = static_cast<const Keccak&>(other);
+    if (o.rate != rate || o.getDigestLength() != getDigestLength()) {
+        throw BadParameterException("Digest state length mismatch");
+    }
+    memcpy(A, o.A, sizeof(A));
+    offset = o.offset;
+    squeezing = o.squeezing;
+
+}
+
+/*
+ * Squeeze output bytes. The state is permuted each time a block of
+ * output has been used up.
+ */
+void Keccak::extract(uint8_t *out, unsigned count) {
+
+    if (!squeezing) {
+        padAbsorb();
+        squeezing = true;
+        offset = 0;
+    }
+
+    for (unsigned i = 0; i < count; ++i) {
+        if (offset == rate) {
+            permute();
+            offset = 0;
+        }
+        unsigned lane = offset / 8;
+        out[i] = ((A[lane] ^ COMPLEMENT[lane]) >> ((offset % 8) * 8)) & 0xff;
+        offset++;
+    }
+
+}
+
+/*
+ * Pad the message and store the digest.
+ */
+void Keccak::finalize(uint8_t *out) {
+
+    extract(out, getDigestLength());
+
+}
+
+/*
+ * Clear the state.
+ */
+void Keccak::initialize() {
+
+    memcpy(A, COMPLEMENT, sizeof(A));
+    offset = 0;
+    squeezing = false;
+
+}
+
+/*
+ * Absorb the buffered input with pad10*1 padding. The domain byte
+ * holds the suffix bits and the first pad bit.
+ */
+void Keccak::padAbsorb() {
+
+    unsigned count;
+    const uint8_t *last = lastChunk(count);
+
+    uint8_t block[200];
+    memcpy(block, last, rate);
+    if (count == rate) {
+        absorb(block);
+        memset(block, 0, rate);
+        count = 0;
+    }
+    block[count] ^= domain;
+    block[rate - 1] ^= 0x80;
+    absorb(block);
+
+}
+
+/*
+ * Keccak-f[1600]. Rounds are done in pairs so the state moves between
+ * two local arrays without copying.
+ */
+void Keccak::permute() {
+
+    uint64_t a[25];
+    uint64_t e[25];
+    memcpy(a, A, sizeof(a));
+    for (int i = 0; i < 24; i += 2) {
+        round(a, e, RC[i]);
+        round(e, a, RC[i + 1]);
+    }
+    memcpy(A, a, sizeof(a));
+
+}
+
+/*
+ * One round, theta, rho, pi, chi and iota, from state S into state E.
+ *
+ * Each output row is computed from the five input lanes that pi
+ * moves into it. With lanes 1, 2, 8, 12, 17 and 20 held complemented,
+ * chi's ~x & y terms become AND, OR and a single NOT per row.
+ */
+#define ROL(x, count) (((x) << (count)) | ((x) >> (64 - (count))))
+
+void Keccak::round(const uint64_t *S, uint64_t *E, uint64_t rc) {
+
+    uint64_t C0 = S[0] ^ S[5] ^ S[10] ^ S[15] ^ S[20];
+    uint64_t C1 = S[1] ^ S[6] ^ S[11] ^ S[16] ^ S[21];
+    uint64_t C2 = S[2] ^ S[7] ^ S[12] ^ S[17] ^ S[22];
+    uint64_t C3 = S[3] ^ S[8] ^ S[13] ^ S[18] ^ S[23];
+    uint64_t C4 = S[4] ^ S[9] ^ S[14] ^ S[19] ^ S[24];
+
+    uint64_t D0 = C4 ^ ROL(C1, 1);
+    uint64_t D1 = C0 ^ ROL(C2, 1);
+    uint64_t D2 = C1 ^ ROL(C3, 1);
+    uint64_t D3 = C2 ^ ROL(C4, 1);
+    uint64_t D4 = C3 ^ ROL(C0, 1);
+
+    uint64_t B0 = S[0] ^ D0;
+    uint64_t B1 = ROL(S[6] ^ D1, 44);
+    uint64_t B2 = ROL(S[12] ^ D2, 43);
+    uint64_t B3 = ROL(S[18] ^ D3, 21);
+    uint64_t B4 = ROL(S[24] ^ D4, 14);
+    E[0] = B0 ^ (B1 | B2) ^ rc;
+    E[1] = B1 ^ (~B2 | B3);
+    E[2] = B2 ^ (B3 & B4);
+    E[3] = B3 ^ (B4 | B0);
+    E[4] = B4 ^ (B0 & B1);
+
+    B0 = ROL(S[3] ^ D3, 28);
+    B1 = ROL(S[9] ^ D4, 20);
+    B2 = ROL(S[10] ^ D0, 3);
+    B3 = ROL(S[16] ^ D1, 45);
+    B4 = ROL(S[22] ^ D2, 61);
+    E[5] = B0 ^ (B1 | B2);
+    E[6] = B1 ^ (B2 & B3);
+    E[7] = B2 ^ (B3 | ~B4);
+    E[8] = B3 ^ (B4 | B0);
+    E[9] = B4 ^ (B0 & B1);
+
+    B0 = ROL(S[1] ^ D1, 1);
+    B1 = ROL(S[7] ^ D2, 6);
+    B2 = ROL(S[13] ^ D3, 25);
+    B3 = ROL(S[19] ^ D4, 8);
+    B4 = ROL(S[20] ^ D0, 18);
+    E[10] = B0 ^ (B1 | B2);
+    E[11] = B1 ^ (B2 & B3);
+    E[12] = B2 ^ (~B3 & B4);
+    E[13] = ~B3 ^ (B4 | B0);
+    E[14] = B4 ^ (B0 & B1);
+
+    B0 = ROL(S[4] ^ D4, 27);
+    B1 = ROL(S[5] ^ D0, 36);
+    B2 = ROL(S[11] ^ D1, 10);
+    B3 = ROL(S[17] ^ D2, 15);
+    B4 = ROL(S[23] ^ D3, 56);
+    E[15] = B0 ^ (B1 & B2);
+    E[16] = B1 ^ (B2 | B3);
+    E[17] = B2 ^ (~B3 | B4);
+    E[18] = ~B3 ^ (B4 & B0);
+    E[19] = B4 ^ (B0 | B1);
+
+    B0 = ROL(S[2] ^ D2, 62);
+    B1 = ROL(S[8] ^ D3, 55);
+    B2 = ROL(S[14] ^ D4, 39);
+    B3 = ROL(S[15] ^ D0, 41);
+    B4 = ROL(S[21] ^ D1, 2);
+    E[20] = B0 ^ (~B1 & B2);
+    E[21] = ~B1 ^ (B2 | B3);
+    E[22] = B2 ^ (B3 & B4);
+    E[23] = B3 ^ (B4 | B0);
+    E[24] = B4 ^ (B0 & B1);
+
+}
+
+#undef ROL
+
+}
@@ -1,8 +1,9 @@
 #include "digest/SHA1.h"
-#include <coder/Unsigned64.h>
-#include <coder/Unsigned32.h>
-#include <deque>
-#include <memory>
+#include "data/CPUFeatures.h"
+#include <string.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
 
 namespace CK {
 
@@ -15,8 +16,13 @@ const uint32_t SHA1::H5 = 0xc3d2e1f0;
 const uint32_t SHA1::K[] = { 0x5a827999, 0x6ed9eba1, 0x8f1bbcdc, 0xca62c1d6 };
 
 const coder::ByteArray SHA1::DER;
+const bool SHA1::shaExtensions = CPUFeatures::hasSHA();
+
+SHA1::SHA1()
+: DigestBase(64) {
+
+    reset();
 
-SHA1::SHA1() {
 }
 
 SHA1::~SHA1() {
@@ -52,144 +58,190 @@ uint32_t SHA1::f(uint32_t x, uint32_t y, uint32_t z, uint32_t t) const {
 
 }
 
-coder::ByteArray SHA1::finalize(const coder::ByteArray& message) const {
-
-    // Pad the message to an even multiple of 512 bits.
-    coder::ByteArray context(pad(message));
-
-    // Split the message up into 512 bit chunks.
-    uint32_t N = context.getLength() / 64;
-    // We need the chunk array to begin at index 1 so the indexing
-    // works out below.
-    std::deque<coder::ByteArray> chunks;
-    chunks.resize(N + 1, coder::ByteArray(64));
-    int ci = 0;
-    for (unsigned i = 1; i <= N; i++) {
-        for (int j = 0; j < 64; ++j) {
-            chunks[i][j] = context[ci + j];
-        }
-        ci += 64;
+/*
+ * Return a new digest with a copy of the current state.
+ */
+Digest *SHA1::clone() const {
+
+    SHA1 *copy = new SHA1;
+    copy->restoreState(*this);
+    return copy;
+
+}
+
+/*
+ * Process one 512 bit chunk.
+ *
+ * The message schedule is a 16 word ring. Words 0 - 15 are loaded
+ * directly from the chunk, the rest are expanded in place as the
+ * rounds consume them. Nothing is allocated.
+ */
+void SHA1::compress(const uint8_t *chunk) {
+
+#if defined(__x86_64__) || defined(__i386__)
+    if (shaExtensions) {
+        compressSHA(chunk);
+        return;
     }
+#endif
 
-    // Set the initial hash seeds
-    uint32_t *h1 = new uint32_t[N + 1];
-    h1[0] = H1;
-    uint32_t *h2 = new uint32_t[N + 1];
-    h2[0] = H2;
-    uint32_t *h3 = new uint32_t[N + 1];
-    h3[0] = H3;
-    uint32_t *h4 = new uint32_t[N + 1];
-    h4[0] = H4;
-    uint32_t *h5 = new uint32_t[N + 1];
-    h5[0] = H5;
-
-    uint32_t *w = 0;
-    // Process the chunks.
-    for (unsigned i = 1; i <= N; ++i) {
-
-        delete[] w;
-        w = W(chunks[i]);
-
-        uint32_t a = h1[i-1];
-        uint32_t b = h2[i-1];
-        uint32_t c = h3[i-1];
-        uint32_t d = h4[i-1];
-        uint32_t e = h5[i-1];
-
-        for (int t = 0; t < 80; ++t) {
-
-            int k;
-            if (t <= 19) {
-                k = K[0];
-            }
-            else if (t <= 39) {
-                k = K[1];
-            }
-            else if (t <= 59) {
-                k = K[2];
-            }
-            else {
-                k = K[3];
-            }
-
-            uint32_t T = rol(a, 5) + f(b, c, d, t) + e + k + w[t];
-            e = d;
-            d = c;
-            c = rol(b, 30);
-            b = a;
-            a = T;
+    uint32_t w[16];
+    for (int t = 0; t < 16; ++t) {
+        const uint8_t *p = chunk + (t * 4);
+        w[t] = (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16)
+                | (uint32_t(p[2]) << 8) | uint32_t(p[3]);
+    }
 
-        }
+    uint32_t a = H[0];
+    uint32_t b = H[1];
+    uint32_t c = H[2];
+    uint32_t d = H[3];
+    uint32_t e = H[4];
 
-        h1[i] = h1[i-1] + a;
-        h2[i] = h2[i-1] + b;
-        h3[i] = h3[i-1] + c;
-        h4[i] = h4[i-1] + d;
-        h5[i] = h5[i-1] + e;
+    for (int t = 0; t < 80; ++t) {
 
+        uint32_t T = rol(a, 5) + f(b, c, d, t) + e + K[t / 20] + schedule(w, t);
+        e = d;
+        d = c;
+        c = rol(b, 30);
+        b = a;
+        a = T;
+
+    }
+
+    H[0] += a;
+    H[1] += b;
+    H[2] += c;
+    H[3] += d;
+    H[4] += e;
+
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+/*
+ * Process one 512 bit chunk with the Intel SHA extensions.
+ *
+ * sha1rnds4 performs four rounds with the round function selected
+ * by its immediate operand. sha1nexte derives E for the next four
+ * rounds. sha1msg1, sha1msg2 and an xor compute the message
+ * schedule four words at a time.
+ */
+__attribute__((target("sha,sse4.1,ssse3")))
+void SHA1::compressSHA(const uint8_t *chunk) {
+
+    // Byte swap the whole 128 bit word.
+    const __m128i MASK = _mm_set_epi64x(0x0001020304050607ULL, 0x08090a0b0c0d0e0fULL);
+
+    __m128i abcd = _mm_loadu_si128(reinterpret_cast<const __m128i*>(H));
+    abcd = _mm_shuffle_epi32(abcd, 0x1b);
+    __m128i e[2];
+    e[0] = _mm_set_epi32(H[4], 0, 0, 0);
+    e[1] = _mm_setzero_si128();
+    __m128i abcdSave = abcd;
+    __m128i eSave = e[0];
+
+    __m128i m[4];
+    for (int i = 0; i < 4; ++i) {
+        __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(chunk + (i * 16)));
+        m[i] = _mm_shuffle_epi8(in, MASK);
+    }
+
+    // 20 groups of 4 rounds. m[i & 3] holds W(4i) - W(4i+3).
+    for (int i = 0; i < 20; ++i) {
+        __m128i& mi = m[i & 3];
+        __m128i& ei = e[i & 1];
+        if (i == 0) {
+            ei = _mm_add_epi32(ei, mi);
+        }
+        else {
+            ei = _mm_sha1nexte_epu32(ei, mi);
+        }
+        e[(i + 1) & 1] = abcd;
+        if (i >= 3 && i <= 18) {
+            __m128i& next = m[(i + 1) & 3];
+            next = _mm_sha1msg2_epu32(next, mi);
+        }
+        switch (i / 5) {
+            case 0:
+                abcd = _mm_sha1rnds4_epu32(abcd, ei, 0);
+                break;
+            case 1:
+                abcd = _mm_sha1rnds4_epu32(abcd, ei, 1);
+                break;
+            case 2:
+                abcd = _mm_sha1rnds4_epu32(abcd, ei, 2);
+                break;
+            default:
+                abcd = _mm_sha1rnds4_epu32(abcd, ei, 3);
+                break;
+        }
+        if (i >= 1 && i <= 16) {
+            __m128i& prev = m[(i - 1) & 3];
+            prev = _mm_sha1msg1_epu32(prev, mi);
+        }
+        if (i >= 2 && i <= 17) {
+            __m128i& prev2 = m[(i - 2) & 3];
+            prev2 = _mm_xor_si128(prev2, mi);
+        }
     }
 
-    coder::ByteArray d;
-    coder::Unsigned32 u32(h1[N]);
-    d.append(u32.getEncoded(coder::bigendian));
-    u32.setValue(h2[N]);
-    d.append(u32.getEncoded(coder::bigendian));
-    u32.setValue(h3[N]);
-    d.append(u32.getEncoded(coder::bigendian));
-    u32.setValue(h4[N]);
-    d.append(u32.getEncoded(coder::bigendian));
-    u32.setValue(h5[N]);
-    d.append(u32.getEncoded(coder::bigendian));
-
-    delete[] h1;
-    delete[] h2;
-    delete[] h3;
-    delete[] h4;
-    delete[] h5;
-
-    return d;
+    e[0] = _mm_sha1nexte_epu32(e[0], eSave);
+    abcd = _mm_add_epi32(abcd, abcdSave);
+
+    abcd = _mm_shuffle_epi32(abcd, 0x1b);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(H), abcd);
+    H[4] = _mm_extract_epi32(e[0], 3);
 
 }
+#endif
+
+/*
+ * Copy the hash state of another SHA-1.
+ */
+void SHA1::copyState(const DigestBase& other) {
+
+    const SHA1& o = static_cast<const SHA1&>(other);
+    memcpy(H, o.H, sizeof(H));
 
+}
 
 /*
- * Maj function.
+ * Pad the message to an even multiple of 512 bits and store the
+ * hash value big-endian.
  */
-uint32_t SHA1::Maj(uint32_t x, uint32_t y, uint32_t z) const {
+void SHA1::finalize(uint8_t *out) {
 
-  	uint32_t r = (x & y) ^ (x & z) ^ (y & z);
-    return r;
+    pad(8);
+
+    for (int i = 0; i < 5; ++i) {
+        out[i * 4] = H[i] >> 24;
+        out[(i * 4) + 1] = H[i] >> 16;
+        out[(i * 4) + 2] = H[i] >> 8;
+        out[(i * 4) + 3] = H[i];
+    }
+
+}
+
+/*
+ * Set the initial hash seeds.
+ */
+void SHA1::initialize() {
+
+    H[0] = H1;
+    H[1] = H2;
+    H[2] = H3;
+    H[3] = H4;
+    H[4] = H5;
 
 }
 
 /*
- * Pad the input array to an even multiple of 512 bits.
+ * Maj function.
  */
-coder::ByteArray SHA1::pad(const coder::ByteArray& in) const {
-
-    // Message size in bits - l
-    long l = in.getLength() * 8;
-
-    /*
-     * Pad the message such that k + 1 + l is congruent to
-     * 448 mod 512, where k + 1 is the padding length and l is the
-     * message length. The message is always padded with a byte
-     * value of 0x80, which is a single bit added to the end of
-     * the message.
-     */
-    coder::ByteArray work = in;
-    work.append(0x80);
-    // 512 bits = 64 bytes. The padded message includes the 64 bit
-    // big endian representation of the message length in bits, so
-    // in order to make the message modulo 512, we add bytes until
-    // the whole message, including the length encoding is an even
-    // multiple of 64,
-    coder::ByteArray pad(64 - ((work.getLength() + 8) % 64));
-    work.append(pad);
-    // Append the 64 bit encoded bit length
-    coder::Unsigned64 l64(l);
-    work.append(l64.getEncoded(coder::bigendian));
-    return work;
+uint32_t SHA1::Maj(uint32_t x, uint32_t y, uint32_t z) const {
+
+  	uint32_t r = (x & y) ^ (x & z) ^ (y & z);
+    return r;
 
 }
 
@@ -203,40 +255,26 @@ uint32_t SHA1::Parity(uint32_t x, uint32_t y, uint32_t z) const {
 }
 
 /*
- * Rotate left (shift left carry the msb).
+ * Rotate left.
  */
 uint32_t SHA1::rol(uint32_t x, int count) const {
 
-    uint32_t result = x;
-    for (int i = 1; i <= count; ++i) {
-        uint32_t carry = (result >> 31) & 0x01;
-        result = (result << 1) | carry;
-    }
-
-    return result;
+    return (x << count) | (x >> (32 - count));
 
 }
 
 /*
- * W function. Compute expanded message blocks via the SHA-1
- * message schedule.
+ * Return message schedule word t, expanding the ring in place.
+ *
+ * W(t) = ROTL1(W(t-3) ⊕ W(t-8) ⊕ W(t-14) ⊕ W(t-16)), 16 ≤ t < 80
  */
-uint32_t *SHA1::W(const coder::ByteArray& chunk) const {
-
-    uint32_t *w = new uint32_t[80];
-
-    coder::Unsigned32 u32;
-    for (int t = 0; t < 16; ++t) {
-        int i = t * 4;
-        u32.decode(chunk.range(i, 4), coder::bigendian);
-        w[t] = u32.getValue();
-    }
+uint32_t SHA1::schedule(uint32_t *w, int t) const {
 
-    for (int t = 16; t < 80; ++t) {
-        w[t] = rol((w[t-3] ^ w[t-8] ^ w[t-14] ^ w[t-16]), 1);
+    if (t >= 16) {
+        w[t & 15] = rol(w[(t - 3) & 15] ^ w[(t - 8) & 15] ^ w[(t - 14) & 15]
+                                                    ^ w[t & 15], 1);
     }
-		
-    return w;
+    return w[t & 15];
 
 }
 
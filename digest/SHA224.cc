@@ -0,0 +1,66 @@
+#include "digest/SHA224.h"
+
+namespace CK {
+
+// Static initializers
+const uint32_t SHA224::H1 = 0xc1059ed8;
+const uint32_t SHA224::H2 = 0x367cd507;
+const uint32_t SHA224::H3 = 0x3070dd17;
+const uint32_t SHA224::H4 = 0xf70e5939;
+const uint32_t SHA224::H5 = 0xffc00b31;
+const uint32_t SHA224::H6 = 0x68581511;
+const uint32_t SHA224::H7 = 0x64f98fa7;
+const uint32_t SHA224::H8 = 0xbefa4fa4;
+
+const uint8_t DERbytes[] = { 0x30, 0x2d, 0x30, 0x0d, 0x06, 0x09, 0x60, 0x86,
+                                    0x48, 0x01, 0x65, 0x03, 0x04, 0x02, 0x04, 0x05,
+                                    0x00, 0x04, 0x1c };
+
+const coder::ByteArray SHA224::DER(DERbytes, sizeof(DERbytes));
+
+SHA224::SHA224() {
+
+    reset();
+
+}
+
+SHA224::~SHA224() {
+}
+
+/*
+ * Return a new digest with a copy of the current state.
+ */
+Digest *SHA224::clone() const {
+
+    SHA224 *copy = new SHA224;
+    copy->restoreState(*this);
+    return copy;
+
+}
+
+/*
+ * Return the ASN.1 encoding identifier
+ */
+const coder::ByteArray& SHA224::getDER() const {
+
+    return DER;
+
+}
+
+/*
+ * Set the initial hash seeds.
+ */
+void SHA224::initialize() {
+
+    H[0] = H1;
+    H[1] = H2;
+    H[2] = H3;
+    H[3] = H4;
+    H[4] = H5;
+    H[5] = H6;
+    H[6] = H7;
+    H[7] = H8;
+
+}
+
+}
@@ -1,8 +1,9 @@
 #include "digest/SHA256.h"
-#include <coder/Unsigned32.h>
-#include <coder/Unsigned64.h>
+#include "data/CPUFeatures.h"
 #include <string.h>
-#include <climits>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
 
 namespace CK {
 
@@ -28,8 +29,13 @@ const uint8_t DERbytes[] = { 0x30, 0x31, 0x30, 0x0d, 0x06, 0x09, 0x60, 0x86,
                                 0x48, 0x01, 0x65, 0x03, 0x04, 0x02, 0x01, 0x05,
                                 0x00, 0x04, 0x20 };
 const coder::ByteArray SHA256::DER(DERbytes, sizeof(DERbytes));
+const bool SHA256::shaExtensions = CPUFeatures::hasSHA();
+
+SHA256::SHA256()
+: DigestBase(64) {
+
+    reset();
 
-SHA256::SHA256(){
 }
 
 SHA256::~SHA256() {
@@ -40,121 +46,164 @@ SHA256::~SHA256() {
  *                          (~X)
  *   No corresponding X bar character
  */
-unsigned SHA256::Ch(unsigned x, unsigned y, unsigned z) const {
+uint32_t SHA256::Ch(uint32_t x, uint32_t y, uint32_t z) const {
 
     return (x & y) ^ ((~x) & z);
             
 }
 
 /*
- * Decompose the message into 64 32 bit blocks.
- *
- * Split the message into 16 32 bit blocks by concatenating bytes.
- *
- * Generate 48 32 bit blocks with this formula.
+ * Return a new digest with a copy of the current state.
+ */
+Digest *SHA256::clone() const {
+
+    SHA256 *copy = new SHA256;
+    copy->restoreState(*this);
+    return copy;
+
+}
+
+/*
+ * Process one 512 bit chunk.
  *
- * W(i) = σ1(W(i−2)) + W(i−7) + σ0(W(i−15)) + W(i−16), 17 ≤ i ≤ 64
+ * The message schedule is a 16 word ring. Words 0 - 15 are loaded
+ * directly from the chunk, the rest are expanded in place as the
+ * rounds consume them. Rounds are unrolled by 8 with the working
+ * variables rotated through the argument lists, so nothing is moved
+ * between rounds and nothing is allocated.
  */
-SHA256::W SHA256::decompose(const coder::ByteArray& chunks) const {
+void SHA256::compress(const uint8_t *chunk) {
 
-    W w(64);
+#if defined(__x86_64__) || defined(__i386__)
+    if (shaExtensions) {
+        compressSHA(chunk);
+        return;
+    }
+#endif
 
+    uint32_t w[16];
     for (int j = 0; j < 16; ++j) {
-        coder::Unsigned32 c(chunks.range(j * 4, 4), coder::bigendian);
-        w[j] = c.getValue();
+        const uint8_t *p = chunk + (j * 4);
+        w[j] = (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16)
+                | (uint32_t(p[2]) << 8) | uint32_t(p[3]);
     }
 
-    for (int j = 16; j < 64; ++j) {
-        w[j] = sigma1(w[j-2]) + w[j-7] + sigma0(w[j-15]) + w[j-16];
+    uint32_t a = H[0];
+    uint32_t b = H[1];
+    uint32_t c = H[2];
+    uint32_t d = H[3];
+    uint32_t e = H[4];
+    uint32_t f = H[5];
+    uint32_t g = H[6];
+    uint32_t h = H[7];
+
+    for (int j = 0; j < 64; j += 8) {
+        round(a, b, c, d, e, f, g, h, K[j] + schedule(w, j));
+        round(h, a, b, c, d, e, f, g, K[j+1] + schedule(w, j+1));
+        round(g, h, a, b, c, d, e, f, K[j+2] + schedule(w, j+2));
+        round(f, g, h, a, b, c, d, e, K[j+3] + schedule(w, j+3));
+        round(e, f, g, h, a, b, c, d, K[j+4] + schedule(w, j+4));
+        round(d, e, f, g, h, a, b, c, K[j+5] + schedule(w, j+5));
+        round(c, d, e, f, g, h, a, b, K[j+6] + schedule(w, j+6));
+        round(b, c, d, e, f, g, h, a, K[j+7] + schedule(w, j+7));
     }
 
-    return w;
+    H[0] += a;
+    H[1] += b;
+    H[2] += c;
+    H[3] += d;
+    H[4] += e;
+    H[5] += f;
+    H[6] += g;
+    H[7] += h;
 
 }
 
-coder::ByteArray SHA256::finalize(const coder::ByteArray& in) const {
-
-    // Pad the message to an even multiple of 512 bits.
-    coder::ByteArray context(pad(in));
+#if defined(__x86_64__) || defined(__i386__)
+/*
+ * Process one 512 bit chunk with the Intel SHA extensions.
+ *
+ * sha256rnds2 keeps the state as ABEF and CDGH and performs two
+ * rounds per instruction. sha256msg1 and sha256msg2 compute the
+ * message schedule four words at a time.
+ */
+__attribute__((target("sha,sse4.1,ssse3")))
+void SHA256::compressSHA(const uint8_t *chunk) {
+
+    // Byte swap each 32 bit word.
+    const __m128i MASK = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+
+    __m128i tmp = _mm_loadu_si128(reinterpret_cast<const __m128i*>(H));
+    __m128i state1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(H + 4));
+    tmp = _mm_shuffle_epi32(tmp, 0xb1);                 // CDAB
+    state1 = _mm_shuffle_epi32(state1, 0x1b);           // EFGH
+    __m128i state0 = _mm_alignr_epi8(tmp, state1, 8);   // ABEF
+    state1 = _mm_blend_epi16(state1, tmp, 0xf0);        // CDGH
+    __m128i abef = state0;
+    __m128i cdgh = state1;
+
+    __m128i m[4];
+    for (int i = 0; i < 4; ++i) {
+        __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(chunk + (i * 16)));
+        m[i] = _mm_shuffle_epi8(in, MASK);
+    }
 
-    // Split the message up into 512 bit chunks.
-    long n = context.getLength() / 64;
-    // We need the chunk array to begin at index 1 so the indexing
-    // works out below.
-    Chunks chunks;
-    chunks.push_back(coder::ByteArray(0));
-    for (long i = 1; i <= n; i++) {
-        chunks.push_back(context.range((i-1)*64, 64));
+    // 16 groups of 4 rounds. m[i & 3] holds W(4i) - W(4i+3).
+    for (int i = 0; i < 16; ++i) {
+        __m128i& mi = m[i & 3];
+        __m128i msg = _mm_add_epi32(mi,
+                        _mm_loadu_si128(reinterpret_cast<const __m128i*>(K + (i * 4))));
+        state1 = _mm_sha256rnds2_epu32(state1, state0, msg);
+        if (i >= 3 && i <= 14) {
+            __m128i& next = m[(i + 1) & 3];
+            next = _mm_add_epi32(next, _mm_alignr_epi8(mi, m[(i - 1) & 3], 4));
+            next = _mm_sha256msg2_epu32(next, mi);
+        }
+        msg = _mm_shuffle_epi32(msg, 0x0e);
+        state0 = _mm_sha256rnds2_epu32(state0, state1, msg);
+        if (i >= 1 && i <= 12) {
+            __m128i& prev = m[(i - 1) & 3];
+            prev = _mm_sha256msg1_epu32(prev, mi);
+        }
     }
 
-    // Set the initial hash seeds
-    uint32_t h1[n + 1];
-    h1[0] = H1;
-    uint32_t h2[n + 1];
-    h2[0] = H2;
-    uint32_t h3[n + 1];
-    h3[0] = H3;
-    uint32_t h4[n + 1];
-    h4[0] = H4;
-    uint32_t h5[n + 1];
-    h5[0] = H5;
-    uint32_t h6[n + 1];
-    h6[0] = H6;
-    uint32_t h7[n + 1];
-    h7[0] = H7;
-    uint32_t h8[n + 1];
-    h8[0] = H8;
-
-    // Process chunks.
-    for (long i = 1; i <= n; ++i) {
-        uint32_t a = h1[i-1];
-        uint32_t b = h2[i-1];
-        uint32_t c = h3[i-1];
-        uint32_t d = h4[i-1];
-        uint32_t e = h5[i-1];
-        uint32_t f = h6[i-1];
-        uint32_t g = h7[i-1];
-        uint32_t h = h8[i-1];
-
-        W w(decompose(chunks[i]));
-
-        for (int j = 0; j < 64; ++j) {
-
-            uint32_t T1 = h + Sigma1(e) + Ch(e, f, g) + K[j] + w[j];
-            uint32_t T2 = Sigma0(a) + Maj(a, b, c);
-
-            h = g;
-            g = f;
-            f = e;
-            e = d + T1;
-            d = c;
-            c = b;
-            b = a;
-            a = T1 + T2;
+    state0 = _mm_add_epi32(state0, abef);
+    state1 = _mm_add_epi32(state1, cdgh);
 
-        }
+    tmp = _mm_shuffle_epi32(state0, 0x1b);              // FEBA
+    state1 = _mm_shuffle_epi32(state1, 0xb1);           // DCHG
+    state0 = _mm_blend_epi16(tmp, state1, 0xf0);        // DCBA
+    state1 = _mm_alignr_epi8(state1, tmp, 8);           // HGFE
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(H), state0);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(H + 4), state1);
 
-        h1[i] = h1[i-1] + a;
-        h2[i] = h2[i-1] + b;
-        h3[i] = h3[i-1] + c;
-        h4[i] = h4[i-1] + d;
-        h5[i] = h5[i-1] + e;
-        h6[i] = h6[i-1] + f;
-        h7[i] = h7[i-1] + g;
-        h8[i] = h8[i-1] + h;
+}
+#endif
 
-    }
+/*
+ * Copy the hash state of another SHA-256.
+ */
+void SHA256::copyState(const DigestBase& other) {
+
+    const SHA256& o = static_cast<const SHA256&>(other);
+    memcpy(H, o.H, sizeof(H));
+
+}
 
-    coder::ByteArray d(coder::Unsigned32(h1[n]).getEncoded(coder::bigendian)); 
-    d.append(coder::Unsigned32(h2[n]).getEncoded(coder::bigendian)); 
-    d.append(coder::Unsigned32(h3[n]).getEncoded(coder::bigendian)); 
-    d.append(coder::Unsigned32(h4[n]).getEncoded(coder::bigendian)); 
-    d.append(coder::Unsigned32(h5[n]).getEncoded(coder::bigendian)); 
-    d.append(coder::Unsigned32(h6[n]).getEncoded(coder::bigendian)); 
-    d.append(coder::Unsigned32(h7[n]).getEncoded(coder::bigendian)); 
-    d.append(coder::Unsigned32(h8[n]).getEncoded(coder::bigendian)); 
+/*
+ * Pad the message to an even multiple of 512 bits and store the
+ * hash value big-endian, truncated to the digest length.
+ */
+void SHA256::finalize(uint8_t *out) {
 
-    return d;
+    pad(8);
+
+    for (unsigned i = 0; i < getDigestLength() / 4; ++i) {
+        out[i * 4] = H[i] >> 24;
+        out[(i * 4) + 1] = H[i] >> 16;
+        out[(i * 4) + 2] = H[i] >> 8;
+        out[(i * 4) + 3] = H[i];
+    }
 
 }
 
@@ -167,6 +216,22 @@ const coder::ByteArray& SHA256::getDER() const {
 
 }
 
+/*
+ * Set the initial hash seeds.
+ */
+void SHA256::initialize() {
+
+    H[0] = H1;
+    H[1] = H2;
+    H[2] = H3;
+    H[3] = H4;
+    H[4] = H5;
+    H[5] = H6;
+    H[6] = H7;
+    H[7] = H8;
+
+}
+
 /*
  * Maj(X, Y, Z) = (X ∧ Y ) ⊕ (X ∧ Z) ⊕ (Y ∧ Z)
  */
@@ -177,49 +242,44 @@ uint32_t SHA256::Maj(uint32_t x, uint32_t y, uint32_t z) const {
 }
 
 /*
- * Pad the input array to an even multiple of 512 bits.
+ * Logical rotate right function.
+ */
+uint32_t SHA256::ror(uint32_t reg, int count) const {
+
+    return (reg >> count) | (reg << (32 - count));
+    
+}
+
+/*
+ * One compression round.
+ *
+ * T1 = h + Σ1(e) + Ch(e, f, g) + K(j) + W(j)
+ * T2 = Σ0(a) + Maj(a, b, c)
+ *
+ * Only d and h change. The caller shifts the other variables by
+ * rotating the argument order.
  */
-coder::ByteArray SHA256:: pad(const coder::ByteArray& in) const {
-
-    // Message size in bits - l
-    long l = in.getLength() * 8;
-
-    /*
-     * Pad the message such that k + 1 + l is congruent to
-     * 448 mod 512, where k + 1 is the padding length and l is the
-     * message length. The message is always padded with a byte
-     * value of 0x80, which is a single bit added to the end of
-     * the message.
-     */
-    coder::ByteArray work = in;
-    work.append(0x80);
-    // 512 bits = 64 bytes. The padded message includes the 64 bit
-    // big endian representation of the message length in bits, so
-    // in order to make the message modulo 512, we add bytes until
-    // the whole message, including the length encoding is an even
-    // multiple of 64,
-    coder::ByteArray pad(64 - ((work.getLength() + 8) % 64));
-    work.append(pad);
-    // Append the 64 bit encoded bit length
-    coder::Unsigned64 l64(l);
-    work.append(l64.getEncoded(coder::bigendian));
-    return work;
+void SHA256::round(uint32_t a, uint32_t b, uint32_t c, uint32_t& d, uint32_t e,
+                    uint32_t f, uint32_t g, uint32_t& h, uint32_t kw) const {
+
+    uint32_t T1 = h + Sigma1(e) + Ch(e, f, g) + kw;
+    d += T1;
+    h = T1 + Sigma0(a) + Maj(a, b, c);
 
 }
 
 /*
- * Logical rotate right function.
+ * Return message schedule word j, expanding the ring in place.
+ *
+ * W(j) = σ1(W(j−2)) + W(j−7) + σ0(W(j−15)) + W(j−16), 16 ≤ j < 64
  */
-uint32_t SHA256::ror(uint32_t reg, int count) const {
+uint32_t SHA256::schedule(uint32_t *w, int j) const {
 
-    unsigned msb = (UINT_MAX >> 1) ^ UINT_MAX;
-    unsigned result = reg;
-    for (int i = 1; i <= count; ++i) {
-        unsigned carry = result & 1;
-        result = (result >> 1) | (carry * msb);
+    if (j >= 16) {
+        w[j & 15] += sigma1(w[(j - 2) & 15]) + w[(j - 7) & 15] + sigma0(w[(j - 15) & 15]);
     }
-    return result;
-    
+    return w[j & 15];
+
 }
 
 /*
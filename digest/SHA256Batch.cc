@@ -0,0 +1,291 @@
+#include "digest/SHA256Batch.h"
+#include "digest/SHA256.h"
+#include "data/CPUFeatures.h"
+#include <algorithm>
+#include <string.h>
+
+namespace CK {
+
+/*
+ * SIMD lanes are written with the GCC/Clang vector extensions. The
+ * kernels are instantiated once per vector width and compiled for
+ * the matching instruction set with target attributes.
+ */
+typedef uint32_t Lanes4 __attribute__((vector_size(16)));
+typedef uint32_t Lanes8 __attribute__((vector_size(32)));
+typedef uint32_t Lanes16 __attribute__((vector_size(64)));
+
+// A helper function would pass vectors by value, which has no stable
+// ABI outside the target attributed kernels.
+#define LANE_ROR(x, count) (((x) >> (count)) | ((x) << (32 - (count))))
+
+/*
+ * SHA-256 compression across every lane of V. Lane i of row r in
+ * state and block belongs to message i.
+ */
+template <typename V> inline __attribute__((always_inline))
+void laneCompress(uint32_t (&state)[8][16], const uint32_t (&block)[16][16],
+                                                            const uint32_t *K) {
+
+    V H[8];
+    V w[16];
+    for (int i = 0; i < 8; ++i) {
+        memcpy(&H[i], state[i], sizeof(V));
+    }
+    for (int i = 0; i < 16; ++i) {
+        memcpy(&w[i], block[i], sizeof(V));
+    }
+
+    V a = H[0];
+    V b = H[1];
+    V c = H[2];
+    V d = H[3];
+    V e = H[4];
+    V f = H[5];
+    V g = H[6];
+    V h = H[7];
+
+    for (int j = 0; j < 64; ++j) {
+        if (j >= 16) {
+            V w2 = w[(j - 2) & 15];
+            V w15 = w[(j - 15) & 15];
+            w[j & 15] += (LANE_ROR(w2, 17) ^ LANE_ROR(w2, 19) ^ (w2 >> 10))
+                            + w[(j - 7) & 15]
+                            + (LANE_ROR(w15, 7) ^ LANE_ROR(w15, 18) ^ (w15 >> 3));
+        }
+        V T1 = h + (LANE_ROR(e, 6) ^ LANE_ROR(e, 11) ^ LANE_ROR(e, 25))
+                    + ((e & f) ^ (~e & g)) + K[j] + w[j & 15];
+        V T2 = (LANE_ROR(a, 2) ^ LANE_ROR(a, 13) ^ LANE_ROR(a, 22))
+                    + ((a & b) ^ (a & c) ^ (b & c));
+        h = g;
+        g = f;
+        f = e;
+        e = d + T1;
+        d = c;
+        c = b;
+        b = a;
+        a = T1 + T2;
+    }
+
+    H[0] += a;
+    H[1] += b;
+    H[2] += c;
+    H[3] += d;
+    H[4] += e;
+    H[5] += f;
+    H[6] += g;
+    H[7] += h;
+    for (int i = 0; i < 8; ++i) {
+        memcpy(state[i], &H[i], sizeof(V));
+    }
+
+}
+
+#undef LANE_ROR
+
+void SHA256Batch::compress4(LaneState& state, const LaneBlock& block) {
+
+    laneCompress<Lanes4>(state, block, SHA256::K);
+
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+__attribute__((target("avx2")))
+void SHA256Batch::compress8(LaneState& state, const LaneBlock& block) {
+
+    laneCompress<Lanes8>(state, block, SHA256::K);
+
+}
+
+__attribute__((target("avx512f")))
+void SHA256Batch::compress16(LaneState& state, const LaneBlock& block) {
+
+    laneCompress<Lanes16>(state, block, SHA256::K);
+
+}
+#endif
+
+SHA256Batch::SHA256Batch()
+: lanes(4),
+  kernel(compress4) {
+
+#if defined(__x86_64__) || defined(__i386__)
+    if (CPUFeatures::hasAVX512()) {
+        lanes = 16;
+        kernel = compress16;
+    }
+    else if (CPUFeatures::hasAVX2()) {
+        lanes = 8;
+        kernel = compress8;
+    }
+#endif
+
+}
+
+SHA256Batch::~SHA256Batch() {
+}
+
+/*
+ * Hash each message.
+ */
+SHA256Batch::Digests SHA256Batch::digest(const Messages& messages) {
+
+    unsigned count = messages.size();
+    Job *jobs = new Job[count];
+    uint8_t *buffer = loadMessages(messages, jobs);
+    uint8_t *out = new uint8_t[count * 32];
+    uint32_t iv[8] = { SHA256::H1, SHA256::H2, SHA256::H3, SHA256::H4,
+                       SHA256::H5, SHA256::H6, SHA256::H7, SHA256::H8 };
+    for (unsigned i = 0; i < count; ++i) {
+        jobs[i].iv = iv;
+        jobs[i].prefix = 0;
+        jobs[i].out = out + (i * 32);
+    }
+
+    run(jobs, count);
+
+    Digests digests;
+    for (unsigned i = 0; i < count; ++i) {
+        digests.push_back(coder::ByteArray(out + (i * 32), 32));
+    }
+
+    delete[] out;
+    delete[] buffer;
+    delete[] jobs;
+    return digests;
+
+}
+
+/*
+ * Load message block index of a job into a lane. The block is copied
+ * from the message and padded on the fly.
+ */
+void SHA256Batch::fillBlock(const Job& job, uint64_t index, uint64_t blocks,
+                                        LaneBlock& block, unsigned lane) const {
+
+    uint64_t start = index * 64;
+    uint64_t count = start < job.length ? std::min(job.length - start, uint64_t(64)) : 0;
+    uint8_t bytes[64];
+    memcpy(bytes, job.message + start, count);
+    if (count < 64) {
+        memset(bytes + count, 0, 64 - count);
+        if (start + count == job.length) {
+            bytes[count] = 0x80;
+        }
+    }
+    if (index == blocks - 1) {
+        uint64_t bits = (job.prefix + job.length) << 3;
+        for (int i = 0; i < 8; ++i) {
+            bytes[63 - i] = (bits >> (i * 8)) & 0xff;
+        }
+    }
+
+    for (int t = 0; t < 16; ++t) {
+        const uint8_t *p = bytes + (t * 4);
+        block[t][lane] = (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16)
+                            | (uint32_t(p[2]) << 8) | uint32_t(p[3]);
+    }
+
+}
+
+/*
+ * Copy the messages end to end into one buffer, which the caller
+ * deletes, and point each job at its message. Each message is read
+ * out of its array once, and fillBlock copies whole blocks from there.
+ */
+uint8_t *SHA256Batch::loadMessages(const Messages& messages, Job *jobs) {
+
+    uint64_t total = 0;
+    for (unsigned i = 0; i < messages.size(); ++i) {
+        total += messages[i].getLength();
+    }
+
+    uint8_t *buffer = new uint8_t[std::max(total, uint64_t(1))];
+    uint8_t *p = buffer;
+    for (unsigned i = 0; i < messages.size(); ++i) {
+        const coder::ByteArray& message(messages[i]);
+        uint64_t length = message.getLength();
+        for (uint64_t j = 0; j < length; ++j) {
+            p[j] = message[j];
+        }
+        jobs[i].message = p;
+        jobs[i].length = length;
+        p += length;
+    }
+    return buffer;
+
+}
+
+/*
+ * Run the jobs through the lanes. Each lane takes the next waiting
+ * job as soon as its current message is finished, so messages of
+ * different lengths keep the lanes busy. Idle lanes are computed
+ * and ignored.
+ */
+void SHA256Batch::run(Job *jobs, unsigned count) {
+
+    LaneState state;
+    LaneBlock block;
+    memset(state, 0, sizeof(state));
+    memset(block, 0, sizeof(block));
+
+    Job *current[MAX_LANES];
+    uint64_t index[MAX_LANES];
+    uint64_t blocks[MAX_LANES];
+    unsigned next = 0;
+    unsigned active = 0;
+
+    for (unsigned lane = 0; lane < lanes; ++lane) {
+        current[lane] = 0;
+        if (next < count) {
+            Job& job(jobs[next++]);
+            current[lane] = &job;
+            index[lane] = 0;
+            // Message, one pad byte and the 64 bit length.
+            blocks[lane] = (job.length + 72) / 64;
+            for (int i = 0; i < 8; ++i) {
+                state[i][lane] = job.iv[i];
+            }
+            active++;
+        }
+    }
+
+    while (active > 0) {
+        for (unsigned lane = 0; lane < lanes; ++lane) {
+            if (current[lane] != 0) {
+                fillBlock(*current[lane], index[lane], blocks[lane], block, lane);
+            }
+        }
+
+        kernel(state, block);
+
+        for (unsigned lane = 0; lane < lanes; ++lane) {
+            if (current[lane] == 0 || ++index[lane] < blocks[lane]) {
+                continue;
+            }
+            uint8_t *out = current[lane]->out;
+            for (int i = 0; i < 8; ++i) {
+                uint32_t h = state[i][lane];
+                out[i * 4] = h >> 24;
+                out[(i * 4) + 1] = (h >> 16) & 0xff;
+                out[(i * 4) + 2] = (h >> 8) & 0xff;
+                out[(i * 4) + 3] = h & 0xff;
+            }
+            current[lane] = 0;
+            active--;
+            if (next < count) {
+                Job& job(jobs[next++]);
+                current[lane] = &job;
+                index[lane] = 0;
+                blocks[lane] = (job.length + 72) / 64;
+                for (int i = 0; i < 8; ++i) {
+                    state[i][lane] = job.iv[i];
+                }
+                active++;
+            }
+        }
+    }
+
+}
+
+}
@@ -0,0 +1,149 @@
+#include "digest/SHA256Tree.h"
+#include "digest/SHA256.h"
+#include "data/MappedFile.h"
+#include "exceptions/BadParameterException.h"
+#include <algorithm>
+#include <exception>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <string.h>
+
+namespace CK {
+
+SHA256Tree::SHA256Tree(unsigned ls, unsigned t)
+: leafSize(ls),
+  threads(t) {
+
+    if (leafSize == 0) {
+        throw BadParameterException("Invalid leaf size");
+    }
+    if (threads == 0) {
+        threads = std::max(1U, std::thread::hardware_concurrency());
+    }
+
+}
+
+SHA256Tree::~SHA256Tree() {
+}
+
+/*
+ * Hash a byte array. The threads need the bytes in one memory range,
+ * so they are copied out of the array first.
+ */
+coder::ByteArray SHA256Tree::digest(const coder::ByteArray& bytes) {
+
+    uint64_t length = bytes.getLength();
+    if (length == 0) {
+        return digest(0, 0);
+    }
+    std::unique_ptr<uint8_t[]> data(bytes.asArray());
+    return digest(data.get(), length);
+
+}
+
+/*
+ * Hash a memory range.
+ *
+ * The leaves are split into one contiguous run per thread. The leaf
+ * hashes are then combined a level at a time. An odd node at the end
+ * of a level moves up unchanged, which gives the RFC 6962 shape.
+ */
+coder::ByteArray SHA256Tree::digest(const uint8_t *bytes, uint64_t length) {
+
+    if (length == 0) {
+        SHA256 sha;
+        return sha.digest();
+    }
+
+    uint64_t leaves = (length + leafSize - 1) / leafSize;
+    std::unique_ptr<uint8_t[][32]> hashes(new uint8_t[leaves][32]);
+
+    uint64_t workers = std::min(uint64_t(threads), leaves);
+    uint64_t share = leaves / workers;
+    uint64_t extra = leaves % workers;
+    uint8_t (*leafHashes)[32] = hashes.get();
+    // Threads that have started are always joined, and an exception on
+    // any thread is passed to the caller once they have been.
+    std::vector<std::exception_ptr> errors(workers - 1);
+    std::vector<std::thread> pool;
+    pool.reserve(workers - 1);
+    uint64_t first = 0;
+    try {
+        for (uint64_t w = 0; w < workers - 1; ++w) {
+            uint64_t count = share + (w < extra ? 1 : 0);
+            pool.push_back(std::thread([this, bytes, length, first, count,
+                                                leafHashes, w, &errors] {
+                try {
+                    hashLeaves(bytes, length, first, count, leafHashes);
+                }
+                catch (...) {
+                    errors[w] = std::current_exception();
+                }
+            }));
+            first += count;
+        }
+        // The last run never has an extra leaf.
+        hashLeaves(bytes, length, first, share, leafHashes);
+    }
+    catch (...) {
+        for (unsigned i = 0; i < pool.size(); ++i) {
+            pool[i].join();
+        }
+        throw;
+    }
+    for (unsigned i = 0; i < pool.size(); ++i) {
+        pool[i].join();
+    }
+    for (unsigned i = 0; i < errors.size(); ++i) {
+        if (errors[i]) {
+            std::rethrow_exception(errors[i]);
+        }
+    }
+
+    SHA256 sha;
+    const uint8_t node = 0x01;
+    for (uint64_t width = leaves; width > 1; width = (width + 1) / 2) {
+        for (uint64_t i = 0; i < width / 2; ++i) {
+            sha.update(node);
+            sha.update(hashes[2 * i], 64);
+            sha.digest(hashes[i]);
+        }
+        if (width % 2 != 0) {
+            memcpy(hashes[width / 2], hashes[width - 1], 32);
+        }
+    }
+
+    return coder::ByteArray(hashes[0], 32);
+
+}
+
+/*
+ * Hash a file. The file is memory mapped and the leaves are hashed
+ * from the mapped pages.
+ */
+coder::ByteArray SHA256Tree::digestFile(const std::string& path) {
+
+    MappedFile file(path);
+    return digest(file.getData(), file.getLength());
+
+}
+
+/*
+ * Hash count leaves starting at leaf first.
+ */
+void SHA256Tree::hashLeaves(const uint8_t *bytes, uint64_t length, uint64_t first,
+                                    uint64_t count, uint8_t (*hashes)[32]) const {
+
+    SHA256 sha;
+    const uint8_t leaf = 0x00;
+    for (uint64_t i = first; i < first + count; ++i) {
+        uint64_t offset = i * leafSize;
+        sha.update(leaf);
+        sha.update(bytes + offset, std::min(uint64_t(leafSize), length - offset));
+        sha.digest(hashes[i]);
+    }
+
+}
+
+}
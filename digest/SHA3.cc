@@ -0,0 +1,71 @@
+#include "digest/SHA3.h"
+#include "exceptions/BadParameterException.h"
+
+namespace CK {
+
+// Static initializers
+const uint8_t DER224bytes[] = { 0x30, 0x2d, 0x30, 0x0d, 0x06, 0x09, 0x60, 0x86,
+                                    0x48, 0x01, 0x65, 0x03, 0x04, 0x02, 0x07, 0x05,
+                                    0x00, 0x04, 0x1c };
+const uint8_t DER256bytes[] = { 0x30, 0x31, 0x30, 0x0d, 0x06, 0x09, 0x60, 0x86,
+                                    0x48, 0x01, 0x65, 0x03, 0x04, 0x02, 0x08, 0x05,
+                                    0x00, 0x04, 0x20 };
+const uint8_t DER384bytes[] = { 0x30, 0x41, 0x30, 0x0d, 0x06, 0x09, 0x60, 0x86,
+                                    0x48, 0x01, 0x65, 0x03, 0x04, 0x02, 0x09, 0x05,
+                                    0x00, 0x04, 0x30 };
+const uint8_t DER512bytes[] = { 0x30, 0x51, 0x30, 0x0d, 0x06, 0x09, 0x60, 0x86,
+                                    0x48, 0x01, 0x65, 0x03, 0x04, 0x02, 0x0a, 0x05,
+                                    0x00, 0x04, 0x40 };
+
+const coder::ByteArray SHA3::DER224(DER224bytes, sizeof(DER224bytes));
+const coder::ByteArray SHA3::DER256(DER256bytes, sizeof(DER256bytes));
+const coder::ByteArray SHA3::DER384(DER384bytes, sizeof(DER384bytes));
+const coder::ByteArray SHA3::DER512(DER512bytes, sizeof(DER512bytes));
+
+/*
+ * The rate is the state size less twice the digest length. The
+ * domain suffix is 01.
+ */
+SHA3::SHA3(unsigned len)
+: Keccak(len <= 64 ? 200 - (2 * len) : 200, 0x06),
+  length(len) {
+
+    if (length != 28 && length != 32 && length != 48 && length != 64) {
+        throw BadParameterException("Invalid SHA-3 digest length");
+    }
+
+}
+
+SHA3::~SHA3() {
+}
+
+/*
+ * Return a new digest with a copy of the current state.
+ */
+Digest *SHA3::clone() const {
+
+    SHA3 *copy = new SHA3(length);
+    copy->restoreState(*this);
+    return copy;
+
+}
+
+/*
+ * Return the ASN.1 encoding identifier
+ */
+const coder::ByteArray& SHA3::getDER() const {
+
+    switch (length) {
+        case 28:
+            return DER224;
+        case 32:
+            return DER256;
+        case 48:
+            return DER384;
+        default:
+            return DER512;
+    }
+
+}
+
+}
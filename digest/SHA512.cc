@@ -1,8 +1,9 @@
 #include "digest/SHA512.h"
-#include <data/BigInteger.h>
-#include <coder/Unsigned64.h>
+#include "data/CPUFeatures.h"
 #include <string.h>
-#include <climits>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
 
 namespace CK {
 
@@ -43,7 +44,13 @@ const uint8_t DERbytes[] = { 0x30, 0x51, 0x30, 0x0d, 0x06, 0x09, 0x60, 0x86,
 
 const coder::ByteArray SHA512::DER(DERbytes, sizeof(DERbytes));
 
-SHA512::SHA512(){
+const bool SHA512::avx2 = CPUFeatures::hasAVX2();
+
+SHA512::SHA512()
+: DigestBase(128) {
+
+    reset();
+
 }
 
 SHA512::~SHA512() {
@@ -61,114 +68,152 @@ uint64_t SHA512::Ch(uint64_t x, uint64_t y, uint64_t z) const {
 }
 
 /*
- * Decompose the message into 80 64 bit blocks.
- *
- * Split the message into 16 64 bit blocks by concatenating bytes.
- *
- * Generate 48 32 bit blocks with this formula.
- *
- * W(i) = σ1(W(i−2)) + W(i−7) + σ0(W(i−15)) + W(i−16), 17 ≤ i ≤ 64
+ * Return a new digest with a copy of the current state.
  */
-SHA512::W SHA512::decompose(const coder::ByteArray& chunks) const {
+Digest *SHA512::clone() const {
+
+    SHA512 *copy = new SHA512;
+    copy->restoreState(*this);
+    return copy;
 
-    W w(80);
+}
 
+/*
+ * Process one 1024 bit chunk.
+ *
+ * The 80 word message schedule is expanded up front, four words at a
+ * time with AVX2 when it is available, so the rounds are a tight loop
+ * over the working variables. Rounds are unrolled by 8 with the
+ * working variables rotated through the argument lists.
+ */
+void SHA512::compress(const uint8_t *chunk) {
+
+    uint64_t w[80];
     for (int j = 0; j < 16; ++j) {
-        coder::Unsigned64 c(chunks.range(j * 8, 8), coder::bigendian);
-        w[j] = c.getValue();
+        const uint8_t *p = chunk + (j * 8);
+        w[j] = (uint64_t(p[0]) << 56) | (uint64_t(p[1]) << 48)
+                | (uint64_t(p[2]) << 40) | (uint64_t(p[3]) << 32)
+                | (uint64_t(p[4]) << 24) | (uint64_t(p[5]) << 16)
+                | (uint64_t(p[6]) << 8) | uint64_t(p[7]);
     }
 
-    for (int j = 16; j < 80; ++j) {
-        w[j] = sigma1(w[j-2]) + w[j-7] + sigma0(w[j-15]) + w[j-16];
+#if defined(__x86_64__) || defined(__i386__)
+    if (avx2) {
+        expandAVX2(w);
+    }
+    else {
+        expand(w);
+    }
+#else
+    expand(w);
+#endif
+
+    uint64_t a = H[0];
+    uint64_t b = H[1];
+    uint64_t c = H[2];
+    uint64_t d = H[3];
+    uint64_t e = H[4];
+    uint64_t f = H[5];
+    uint64_t g = H[6];
+    uint64_t h = H[7];
+
+    for (int j = 0; j < 80; j += 8) {
+        round(a, b, c, d, e, f, g, h, K[j] + w[j]);
+        round(h, a, b, c, d, e, f, g, K[j+1] + w[j+1]);
+        round(g, h, a, b, c, d, e, f, K[j+2] + w[j+2]);
+        round(f, g, h, a, b, c, d, e, K[j+3] + w[j+3]);
+        round(e, f, g, h, a, b, c, d, K[j+4] + w[j+4]);
+        round(d, e, f, g, h, a, b, c, K[j+5] + w[j+5]);
+        round(c, d, e, f, g, h, a, b, K[j+6] + w[j+6]);
+        round(b, c, d, e, f, g, h, a, K[j+7] + w[j+7]);
     }
 
-    return w;
+    H[0] += a;
+    H[1] += b;
+    H[2] += c;
+    H[3] += d;
+    H[4] += e;
+    H[5] += f;
+    H[6] += g;
+    H[7] += h;
 
 }
 
-coder::ByteArray SHA512::finalize(const coder::ByteArray& in) const {
-
-    // Pad the message to an even multiple of 1024 bits.
-    coder::ByteArray context(pad(in));
+/*
+ * Expand the message schedule.
+ *
+ * W(j) = σ1(W(j−2)) + W(j−7) + σ0(W(j−15)) + W(j−16), 16 ≤ j < 80
+ */
+void SHA512::expand(uint64_t *w) const {
 
-    // Split the message up into 1024 bit chunks.
-    long n = context.getLength() / 128;
-    // We need the chunk array to begin at index 1 so the indexing
-    // works out below.
-    Chunks chunks;
-    chunks.push_back(coder::ByteArray(0));
-    for (long i = 1; i <= n; i++) {
-        chunks.push_back(context.range((i-1)*128, 128));
+    for (int j = 16; j < 80; ++j) {
+        w[j] = sigma1(w[j-2]) + w[j-7] + sigma0(w[j-15]) + w[j-16];
     }
 
-    // Set the initial hash seeds
-    uint64_t h1[n + 1];
-    h1[0] = H1;
-    uint64_t h2[n + 1];
-    h2[0] = H2;
-    uint64_t h3[n + 1];
-    h3[0] = H3;
-    uint64_t h4[n + 1];
-    h4[0] = H4;
-    uint64_t h5[n + 1];
-    h5[0] = H5;
-    uint64_t h6[n + 1];
-    h6[0] = H6;
-    uint64_t h7[n + 1];
-    h7[0] = H7;
-    uint64_t h8[n + 1];
-    h8[0] = H8;
-
-    // Process chunks.
-    for (long i = 1; i <= n; ++i) {
-        uint64_t a = h1[i-1];
-        uint64_t b = h2[i-1];
-        uint64_t c = h3[i-1];
-        uint64_t d = h4[i-1];
-        uint64_t e = h5[i-1];
-        uint64_t f = h6[i-1];
-        uint64_t g = h7[i-1];
-        uint64_t h = h8[i-1];
-
-        W w(decompose(chunks[i]));
-
-        for (int j = 0; j < 80; ++j) {
-
-            uint64_t T1 = h + Sigma1(e) + Ch(e, f, g) + K[j] + w[j];
-            uint64_t T2 = Sigma0(a) + Maj(a, b, c);
-
-            h = g;
-            g = f;
-            f = e;
-            e = d + T1;
-            d = c;
-            c = b;
-            b = a;
-            a = T1 + T2;
+}
 
+#if defined(__x86_64__) || defined(__i386__)
+/*
+ * Expand the message schedule four words at a time with AVX2.
+ *
+ * W(j-16), W(j-7) and σ0(W(j-15)) are independent across the four
+ * words. σ1 depends on W(j-2), so the lower two words are finished
+ * first and their σ1 values complete the upper two. AVX2 has no 64
+ * bit rotate, so rotates are shift pairs.
+ */
+__attribute__((target("avx2")))
+void SHA512::expandAVX2(uint64_t *w) const {
+
+    for (int j = 16; j < 80; j += 4) {
+        __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(w + j - 15));
+        __m256i s0 = _mm256_xor_si256(
+                        _mm256_xor_si256(
+                            _mm256_or_si256(_mm256_srli_epi64(x, 1), _mm256_slli_epi64(x, 63)),
+                            _mm256_or_si256(_mm256_srli_epi64(x, 8), _mm256_slli_epi64(x, 56))),
+                        _mm256_srli_epi64(x, 7));
+        __m256i t = _mm256_add_epi64(
+                        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(w + j - 16)),
+                        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(w + j - 7)));
+        t = _mm256_add_epi64(t, s0);
+
+        __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(w + j - 2));
+        for (int half = 0; half < 2; ++half) {
+            __m128i s1 = _mm_xor_si128(
+                            _mm_xor_si128(
+                                _mm_or_si128(_mm_srli_epi64(y, 19), _mm_slli_epi64(y, 45)),
+                                _mm_or_si128(_mm_srli_epi64(y, 61), _mm_slli_epi64(y, 3))),
+                            _mm_srli_epi64(y, 6));
+            __m128i part = half == 0 ? _mm256_castsi256_si128(t)
+                                     : _mm256_extracti128_si256(t, 1);
+            y = _mm_add_epi64(part, s1);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(w + j + (half * 2)), y);
         }
+    }
 
-        h1[i] = h1[i-1] + a;
-        h2[i] = h2[i-1] + b;
-        h3[i] = h3[i-1] + c;
-        h4[i] = h4[i-1] + d;
-        h5[i] = h5[i-1] + e;
-        h6[i] = h6[i-1] + f;
-        h7[i] = h7[i-1] + g;
-        h8[i] = h8[i-1] + h;
+}
+#endif
 
-    }
+/*
+ * Copy the hash state of another SHA-512.
+ */
+void SHA512::copyState(const DigestBase& other) {
+
+    const SHA512& o = static_cast<const SHA512&>(other);
+    memcpy(H, o.H, sizeof(H));
+
+}
 
-    coder::ByteArray d(coder::Unsigned64(h1[n]).getEncoded(coder::bigendian));
-    d.append(coder::Unsigned64(h2[n]).getEncoded(coder::bigendian));
-    d.append(coder::Unsigned64(h3[n]).getEncoded(coder::bigendian));
-    d.append(coder::Unsigned64(h4[n]).getEncoded(coder::bigendian));
-    d.append(coder::Unsigned64(h5[n]).getEncoded(coder::bigendian));
-    d.append(coder::Unsigned64(h6[n]).getEncoded(coder::bigendian));
-    d.append(coder::Unsigned64(h7[n]).getEncoded(coder::bigendian));
-    d.append(coder::Unsigned64(h8[n]).getEncoded(coder::bigendian));
+/*
+ * Pad the message to an even multiple of 1024 bits and store the
+ * hash value big-endian, truncated to the digest length.
+ */
+void SHA512::finalize(uint8_t *out) {
 
-    return d;
+    pad(16);
+
+    for (unsigned i = 0; i < getDigestLength(); ++i) {
+        out[i] = H[i / 8] >> ((7 - (i % 8)) * 8);
+    }
 
 }
 
@@ -182,48 +227,27 @@ const coder::ByteArray& SHA512::getDER() const {
 }
 
 /*
- * Maj(X, Y, Z) = (X ∧ Y ) ⊕ (X ∧ Z) ⊕ (Y ∧ Z)
+ * Set the initial hash seeds.
  */
-uint64_t SHA512::Maj(uint64_t x, uint64_t y, uint64_t z) const {
+void SHA512::initialize() {
 
-    return (x & y) ^ (x & z) ^ (y & z);
+    H[0] = H1;
+    H[1] = H2;
+    H[2] = H3;
+    H[3] = H4;
+    H[4] = H5;
+    H[5] = H6;
+    H[6] = H7;
+    H[7] = H8;
 
 }
 
 /*
- * Pad the input array to an even multiple of 512 bits.
+ * Maj(X, Y, Z) = (X ∧ Y ) ⊕ (X ∧ Z) ⊕ (Y ∧ Z)
  */
-coder::ByteArray SHA512:: pad(const coder::ByteArray& in) const {
-
-    // Message size in bits - l
-    uint64_t l = in.getLength() * 8;
-
-    /*
-     * Pad the message such that k + 1 + l is congruent to
-     * 960 mod 1024, where k + 1 is the padding length and l is the
-     * message length. The message is always padded with a byte
-     * value of 0x80, which is a single bit added to the end of
-     * the message.
-     */
-    coder::ByteArray work = in;
-    work.append(0x80);
-    // 1024 bits = 128 bytes. The padded message includes the 128 bit
-    // big endian representation of the message length in bits, so
-    // in order to make the message modulo 1024, we add bytes until
-    // the whole message, including the length encoding is an even
-    // multiple of 128,
-    coder::ByteArray pad(128 - ((work.getLength() + 16) % 128));
-    work.append(pad);
-    //while ((work.getLength() + 8)  % 64 != 0) {
-    //    work.append(0); //pad with zeroes.
-    //}
-    // Append the 64 bit encoded bit length
-    BigInteger l128(l);
-    coder::ByteArray b128(l128.getEncoded());
-    pad = coder::ByteArray(16 - b128.getLength());
-    work.append(pad);
-    work.append(b128);
-    return work;
+uint64_t SHA512::Maj(uint64_t x, uint64_t y, uint64_t z) const {
+
+    return (x & y) ^ (x & z) ^ (y & z);
 
 }
 
@@ -232,16 +256,28 @@ coder::ByteArray SHA512:: pad(const coder::ByteArray& in) const {
  */
 uint64_t SHA512::ror(uint64_t reg, int count) const {
 
-    uint64_t msb = (UINT64_MAX >> 1) ^ UINT64_MAX;
-    uint64_t result = reg;
-    for (int i = 1; i <= count; ++i) {
-        uint64_t carry = result & 1;
-        result = (result >> 1) | (carry * msb);
-    }
-    return result;
+    return (reg >> count) | (reg << (64 - count));
     
 }
 
+/*
+ * One compression round.
+ *
+ * T1 = h + Σ1(e) + Ch(e, f, g) + K(j) + W(j)
+ * T2 = Σ0(a) + Maj(a, b, c)
+ *
+ * Only d and h change. The caller shifts the other variables by
+ * rotating the argument order.
+ */
+void SHA512::round(uint64_t a, uint64_t b, uint64_t c, uint64_t& d, uint64_t e,
+                    uint64_t f, uint64_t g, uint64_t& h, uint64_t kw) const {
+
+    uint64_t T1 = h + Sigma1(e) + Ch(e, f, g) + kw;
+    d += T1;
+    h = T1 + Sigma0(a) + Maj(a, b, c);
+
+}
+
 /*
  * σ0(X) = RotR(X, 1) ⊕ RotR(X, 8) ⊕ ShR(X, 7)
  */
@@ -0,0 +1,66 @@
+#include "digest/SHA512_256.h"
+
+namespace CK {
+
+// Static initializers
+const uint64_t SHA512_256::H1 = 0x22312194fc2bf72c;
+const uint64_t SHA512_256::H2 = 0x9f555fa3c84c64c2;
+const uint64_t SHA512_256::H3 = 0x2393b86b6f53b151;
+const uint64_t SHA512_256::H4 = 0x963877195940eabd;
+const uint64_t SHA512_256::H5 = 0x96283ee2a88effe3;
+const uint64_t SHA512_256::H6 = 0xbe5e1e2553863992;
+const uint64_t SHA512_256::H7 = 0x2b0199fc2c85b8aa;
+const uint64_t SHA512_256::H8 = 0x0eb72ddc81c52ca2;
+
+const uint8_t DERbytes[] = { 0x30, 0x31, 0x30, 0x0d, 0x06, 0x09, 0x60, 0x86,
+                                    0x48, 0x01, 0x65, 0x03, 0x04, 0x02, 0x06, 0x05,
+                                    0x00, 0x04, 0x20 };
+
+const coder::ByteArray SHA512_256::DER(DERbytes, sizeof(DERbytes));
+
+SHA512_256::SHA512_256() {
+
+    reset();
+
+}
+
+SHA512_256::~SHA512_256() {
+}
+
+/*
+ * Return a new digest with a copy of the current state.
+ */
+Digest *SHA512_256::clone() const {
+
+    SHA512_256 *copy = new SHA512_256;
+    copy->restoreState(*this);
+    return copy;
+
+}
+
+/*
+ * Return the ASN.1 encoding identifier
+ */
+const coder::ByteArray& SHA512_256::getDER() const {
+
+    return DER;
+
+}
+
+/*
+ * Set the initial hash seeds.
+ */
+void SHA512_256::initialize() {
+
+    H[0] = H1;
+    H[1] = H2;
+    H[2] = H3;
+    H[3] = H4;
+    H[4] = H5;
+    H[5] = H6;
+    H[6] = H7;
+    H[7] = H8;
+
+}
+
+}
@@ -0,0 +1,63 @@
+#include "digest/SHAKE.h"
+#include "exceptions/BadParameterException.h"
+#include <memory>
+
+namespace CK {
+
+// Static initializers
+const coder::ByteArray SHAKE::DER;
+
+/*
+ * The rate is the state size less twice the security strength. The
+ * domain suffix is 1111.
+ */
+SHAKE::SHAKE(unsigned s, unsigned len)
+: Keccak(s == 256 ? 136 : 168, 0x1f),
+  strength(s),
+  length(len) {
+
+    if (strength != 128 && strength != 256) {
+        throw BadParameterException("Invalid SHAKE security strength");
+    }
+    if (length == 0) {
+        throw BadParameterException("Invalid SHAKE digest length");
+    }
+
+}
+
+SHAKE::~SHAKE() {
+}
+
+/*
+ * Return a new digest with a copy of the current state.
+ */
+Digest *SHAKE::clone() const {
+
+    SHAKE *copy = new SHAKE(strength, length);
+    copy->restoreState(*this);
+    return copy;
+
+}
+
+/*
+ * Return the next count bytes of output. The first call pads the
+ * message and ends absorption.
+ */
+coder::ByteArray SHAKE::squeeze(unsigned count) {
+
+    std::unique_ptr<uint8_t[]> out(new uint8_t[count]);
+    extract(out.get(), count);
+    return coder::ByteArray(out.get(), count);
+
+}
+
+/*
+ * Write the next count bytes of output to a caller buffer.
+ */
+void SHAKE::squeeze(uint8_t *out, unsigned count) {
+
+    extract(out, count);
+
+}
+
+}
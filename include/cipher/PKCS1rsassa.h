@@ -24,6 +24,8 @@ class PKCS1rsassa : public RSA {
         coder::ByteArray encrypt(const RSAPublicKey& K,
                                 const coder::ByteArray& C);
         coder::ByteArray sign(const RSAPrivateKey& K, const coder::ByteArray& M);
+        // Sign each of the messages with K.
+        Signatures sign(const RSAPrivateKey& K, const Messages& M);
         bool verify(const RSAPublicKey& K, const coder::ByteArray& M,
                                 const coder::ByteArray& S);
 
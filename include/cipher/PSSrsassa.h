@@ -25,11 +25,15 @@ class PSSrsassa : public RSA {
         coder::ByteArray encrypt(const RSAPublicKey& K,
                                 const coder::ByteArray& C);
         coder::ByteArray sign(const RSAPrivateKey& K, const coder::ByteArray& M);
+        // Sign each of the messages with K.
+        Signatures sign(const RSAPrivateKey& K, const Messages& M);
         bool verify(const RSAPublicKey& K, const coder::ByteArray& M,
                                 const coder::ByteArray& S);
 
     private:
         coder::ByteArray emsaPSSEncode(const coder::ByteArray&  M, int emLen);
+        coder::ByteArray emsaPSSEncode(const coder::ByteArray&  M, int emLen,
+                                                    const coder::ByteArray& salt);
         bool emsaPSSVerify(const coder::ByteArray& M, const coder::ByteArray& EM,
                                                             int emBits);
 
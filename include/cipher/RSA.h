@@ -3,6 +3,8 @@
 
 #include "../data/BigInteger.h"
 #include "../jni/JNIReference.h"
+#include <coder/ByteArray.h>
+#include <deque>
 
 namespace CK {
 
@@ -20,6 +22,10 @@ class RSA : public JNIReference {
     private:
         static const BigInteger MASK;
 
+    public:
+        typedef std::deque<coder::ByteArray> Messages;
+        typedef std::deque<coder::ByteArray> Signatures;
+
     public:
         virtual coder::ByteArray
                 decrypt(const RSAPrivateKey& K, const coder::ByteArray& C)=0;
@@ -18,11 +18,49 @@ class BlockCipherMode : public JNIReference {
         BlockCipherMode(const BlockCipherMode& other);
         BlockCipherMode& operator= (const BlockCipherMode& other);
 
+    public:
+        /*
+         * Receives the output of a mode a chunk at a time, as the mode
+         * produces it.
+         */
+        class Output {
+
+            public:
+                virtual ~Output() {}
+                virtual void write(const coder::ByteArray& chunk)=0;
+
+        };
+
+        /*
+         * Output that collects the chunks in one array.
+         */
+        class Buffer : public Output {
+
+            public:
+                Buffer(coder::ByteArray& b) : bytes(b) {}
+                void write(const coder::ByteArray& chunk) { bytes.append(chunk); }
+
+            private:
+                coder::ByteArray& bytes;
+
+        };
+
     public:
         virtual coder::ByteArray decrypt(const coder::ByteArray& ciphertext,
                                             const coder::ByteArray& key)=0;
+        // Decrypt length bytes of ciphertext starting at offset. Modes
+        // that can't work from the view decrypt a copy of the range.
+        virtual coder::ByteArray decryptRange(const coder::ByteArray& ciphertext,
+                                            unsigned offset, unsigned length,
+                                            const coder::ByteArray& key)
+                { return decrypt(ciphertext.range(offset, length), key); }
         virtual coder::ByteArray encrypt(const coder::ByteArray& plaintext,
                                             const coder::ByteArray& key)=0;
+        // Encrypt, writing the ciphertext to out in chunks. Modes that
+        // can't stream write it in one chunk.
+        virtual void encryptStream(const coder::ByteArray& plaintext,
+                                            const coder::ByteArray& key, Output& out)
+                { out.write(encrypt(plaintext, key)); }
         virtual void setIV(const coder::ByteArray& iv)=0;
 
 };
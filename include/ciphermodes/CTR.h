@@ -19,7 +19,11 @@ class CTR : public BlockCipherMode {
 
     public:
         coder::ByteArray decrypt(const coder::ByteArray& ciphertext, const coder::ByteArray& key);
+        coder::ByteArray decryptRange(const coder::ByteArray& ciphertext, unsigned offset,
+                                        unsigned length, const coder::ByteArray& key);
         coder::ByteArray encrypt(const coder::ByteArray& plaintext, const coder::ByteArray& key);
+        void encryptStream(const coder::ByteArray& plaintext, const coder::ByteArray& key,
+                                        Output& out);
         void setIV(const coder::ByteArray& iv);
 
     private:
@@ -0,0 +1,55 @@
+#ifndef ETM_H_INCLUDED
+#define ETM_H_INCLUDED
+
+#include "BlockCipherMode.h"
+#include "../mac/HKDF.h"
+
+namespace CK {
+
+class HMAC;
+
+/*
+ * Encrypt-then-MAC composite mode. The HMAC is computed over the
+ * IV and the ciphertext and appended to the ciphertext. The tag is
+ * verified before anything is decrypted.
+ *
+ * The cipher and the HMAC never share a key. Independent encryption
+ * and MAC keys are derived from the key with HKDF-SHA256. The MAC key
+ * is a digest length, so any cipher key size works with any HMAC.
+ */
+class EtM : public BlockCipherMode {
+
+    public:
+        EtM(BlockCipherMode *c, HMAC* h);
+        ~EtM();
+
+    private:
+        EtM(const EtM& other);
+        EtM& operator= (const EtM& other);
+
+    public:
+        coder::ByteArray decrypt(const coder::ByteArray& ciphertext,
+                                            const coder::ByteArray& key);
+        coder::ByteArray encrypt(const coder::ByteArray& plaintext,
+                                            const coder::ByteArray& key);
+        void setIV(const coder::ByteArray& iv);
+
+    private:
+        void deriveKeys(const coder::ByteArray& key);
+
+    private:
+        BlockCipherMode *cipher;
+        HMAC *hmac;
+        HKDF kdf;
+        coder::ByteArray IV;
+        coder::ByteArray masterKey;
+        coder::ByteArray encryptionKey;
+        coder::ByteArray macKey;
+
+        static const unsigned MAX_TAG = 64;     // Fixed length digests
+
+};
+
+}
+
+#endif  // ETM_H_INCLUDED
@@ -31,6 +31,7 @@ class MtE : public BlockCipherMode {
         HMAC *hmac;
         bool authenticated;
 
+        static const unsigned MAX_MAC = 64;     // Fixed length digests
 
 };
 
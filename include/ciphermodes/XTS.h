@@ -0,0 +1,65 @@
+#ifndef XTS_H_INCLUDED
+#define XTS_H_INCLUDED
+
+#include "BlockCipherMode.h"
+#include <cstdint>
+
+namespace CK {
+
+class BlockCipher;
+
+/*
+ * XEX-based tweaked-codebook mode with ciphertext stealing.
+ * See IEEE 1619 and NIST SP 800-38E.
+ *
+ * The key is the concatenation of the data key and the tweak key.
+ * The IV is the 16 byte tweak value of the data unit (sector).
+ */
+class XTS : public BlockCipherMode {
+
+    public:
+        XTS(BlockCipher *c);
+        ~XTS();
+
+    private:
+        XTS(const XTS& other);
+        XTS& operator= (const XTS& other);
+
+    public:
+        coder::ByteArray decrypt(const coder::ByteArray& ciphertext,
+                                            const coder::ByteArray& key);
+        coder::ByteArray decryptSectors(const coder::ByteArray& ciphertext,
+                                            const coder::ByteArray& key,
+                                            uint64_t firstSector, unsigned sectorSize);
+        coder::ByteArray encrypt(const coder::ByteArray& plaintext,
+                                            const coder::ByteArray& key);
+        coder::ByteArray encryptSectors(const coder::ByteArray& plaintext,
+                                            const coder::ByteArray& key,
+                                            uint64_t firstSector, unsigned sectorSize);
+        void setIV(const coder::ByteArray& iv);
+        void setSector(uint64_t sector);
+
+    private:
+        coder::ByteArray decryptUnit(const coder::ByteArray& ciphertext,
+                                            const coder::ByteArray& i,
+                                            const coder::ByteArray& K1,
+                                            const coder::ByteArray& K2);
+        coder::ByteArray encryptUnit(const coder::ByteArray& plaintext,
+                                            const coder::ByteArray& i,
+                                            const coder::ByteArray& K1,
+                                            const coder::ByteArray& K2);
+        coder::ByteArray tweakSequence(const coder::ByteArray& T0,
+                                            unsigned blocks) const;
+        void splitKey(const coder::ByteArray& key, coder::ByteArray& K1,
+                                            coder::ByteArray& K2) const;
+
+    private:
+        unsigned blockSize;
+        BlockCipher *cipher;
+        coder::ByteArray tweak;
+
+};
+
+}
+
+#endif  // XTS_H_INCLUDED
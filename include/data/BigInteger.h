@@ -26,6 +26,9 @@ class Random;
  */
 class BigInteger : public JNIReference {
 
+    private:
+        friend class MontgomeryContext;
+
     public:
         static const BigInteger ZERO;
         static const BigInteger ONE;
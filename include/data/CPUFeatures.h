@@ -0,0 +1,29 @@
+#ifndef CPUFEATURES_H_INCLUDED
+#define CPUFEATURES_H_INCLUDED
+
+namespace CK {
+
+/*
+ * Runtime detection of optional x86 instruction set extensions.
+ * Every test returns false on other architectures.
+ */
+class CPUFeatures {
+
+    private:
+        CPUFeatures();
+        CPUFeatures(const CPUFeatures& other);
+
+    public:
+        // AVX2 with operating system support for the YMM registers.
+        static bool hasAVX2();
+        // AVX-512 foundation with operating system support for the
+        // ZMM registers.
+        static bool hasAVX512();
+        // Intel SHA extensions with SSSE3 and SSE4.1.
+        static bool hasSHA();
+
+};
+
+}
+
+#endif // CPUFEATURES_H_INCLUDED
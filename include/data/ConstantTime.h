@@ -0,0 +1,36 @@
+#ifndef CONSTANTTIME_H_INCLUDED
+#define CONSTANTTIME_H_INCLUDED
+
+#include "coder/ByteArray.h"
+#include <cstdint>
+
+namespace CK {
+
+/*
+ * Fixed time comparison of secret values such as MACs and tags.
+ *
+ * Every byte is compared, so the time taken doesn't depend on where
+ * the values differ. Only the lengths may be compared early, since
+ * they aren't secret.
+ */
+class ConstantTime {
+
+    private:
+        ConstantTime();
+        ConstantTime(const ConstantTime& other);
+
+    public:
+        static bool equals(const uint8_t *a, const uint8_t *b, unsigned length);
+        // Compare length bytes of a with b starting at offset.
+        static bool equals(const uint8_t *a, const coder::ByteArray& b,
+                                                unsigned offset, unsigned length);
+        static bool equals(const coder::ByteArray& a, const coder::ByteArray& b);
+        // Compare a with the bytes of b starting at offset.
+        static bool equals(const coder::ByteArray& a, const coder::ByteArray& b,
+                                                unsigned offset);
+
+};
+
+}
+
+#endif // CONSTANTTIME_H_INCLUDED
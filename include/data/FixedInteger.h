@@ -0,0 +1,99 @@
+#ifndef FIXEDINTEGER_H_INCLUDED
+#define FIXEDINTEGER_H_INCLUDED
+
+#include <cstdint>
+
+namespace CK {
+
+/*
+ * Unsigned integer of N 64 bit limbs, least significant limb first.
+ *
+ * The limbs are held in the object, so values live on the stack and
+ * nothing is allocated. The loop bounds are constants, which lets the
+ * compiler unroll them. Only what Montgomery arithmetic needs is here.
+ */
+template<unsigned N> class FixedInteger {
+
+    public:
+        FixedInteger() { for (unsigned i = 0; i < N; ++i) limbs[i] = 0; }
+        explicit FixedInteger(const uint64_t *words)
+                { for (unsigned i = 0; i < N; ++i) limbs[i] = words[i]; }
+
+    public:
+        uint64_t& operator[] (unsigned index) { return limbs[index]; }
+        uint64_t operator[] (unsigned index) const { return limbs[index]; }
+
+    public:
+        // Returns bit n, or 0 if n is past the last limb.
+        unsigned bit(unsigned n) const;
+        // Set every limb to zero.
+        void clear() { for (unsigned i = 0; i < N; ++i) limbs[i] = 0; }
+        // Returns the number of significant bits.
+        unsigned bitLength() const;
+        // Copy the limbs to words.
+        void getWords(uint64_t *words) const
+                { for (unsigned i = 0; i < N; ++i) words[i] = limbs[i]; }
+        // Replace this with other where mask is all ones. Mask must be
+        // all ones or all zeros.
+        void select(const FixedInteger& other, uint64_t mask);
+        // this = this - other mod 2^64N. Returns the borrow.
+        uint64_t subtract(const FixedInteger& other);
+
+    private:
+        uint64_t limbs[N];
+
+};
+
+template<unsigned N>
+unsigned FixedInteger<N>::bit(unsigned n) const {
+
+    if (n >= N * 64) {
+        return 0;
+    }
+    return (limbs[n / 64] >> (n % 64)) & 1;
+
+}
+
+template<unsigned N>
+unsigned FixedInteger<N>::bitLength() const {
+
+    for (unsigned i = N; i > 0; --i) {
+        if (limbs[i - 1] != 0) {
+            unsigned bits = (i - 1) * 64;
+            for (uint64_t w = limbs[i - 1]; w != 0; w = w >> 1) {
+                bits++;
+            }
+            return bits;
+        }
+    }
+    return 0;
+
+}
+
+template<unsigned N>
+void FixedInteger<N>::select(const FixedInteger& other, uint64_t mask) {
+
+    for (unsigned i = 0; i < N; ++i) {
+        limbs[i] = (limbs[i] & ~mask) | (other.limbs[i] & mask);
+    }
+
+}
+
+template<unsigned N>
+uint64_t FixedInteger<N>::subtract(const FixedInteger& other) {
+
+    uint64_t borrow = 0;
+    for (unsigned i = 0; i < N; ++i) {
+        uint64_t a = limbs[i];
+        uint64_t d = a - other.limbs[i];
+        uint64_t b1 = d > a;
+        limbs[i] = d - borrow;
+        borrow = b1 | (limbs[i] > d);
+    }
+    return borrow;
+
+}
+
+}
+
+#endif  // FIXEDINTEGER_H_INCLUDED
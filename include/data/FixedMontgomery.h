@@ -0,0 +1,233 @@
+#ifndef FIXEDMONTGOMERY_H_INCLUDED
+#define FIXEDMONTGOMERY_H_INCLUDED
+
+#include "FixedInteger.h"
+#include <cstdint>
+
+namespace CK {
+
+/*
+ * Montgomery arithmetic for an odd modulus n of exactly N limbs, with
+ * R = 2^64N.
+ *
+ * This is the fixed width counterpart of MontgomeryContext, for the
+ * CRT primes of the standard RSA sizes. Products are formed on the
+ * stack a column at a time. The final subtraction of n and the choice
+ * of table entry for a private exponent are masked rather than
+ * branched on or indexed.
+ *
+ * Limb products use the unsigned __int128 extension of GCC and clang.
+ */
+template<unsigned N> class FixedMontgomery {
+
+    private:
+        typedef unsigned __int128 uint128_t;
+
+    private:
+        FixedMontgomery();
+
+    public:
+        // n0 is -n^-1 mod 2^64.
+        FixedMontgomery(const FixedInteger<N>& n, const FixedInteger<N>& r2, uint64_t n0)
+                : n(n), r2(r2), n0(n0) {}
+
+    public:
+        // x = base^exp mod n. The base must be less than n. x may be base.
+        void modPow(FixedInteger<N>& x, const FixedInteger<N>& base,
+                                        const FixedInteger<N>& exp) const;
+        // x = a * b * R^-1 mod n. x may be a or b.
+        void multiply(FixedInteger<N>& x, const FixedInteger<N>& a,
+                                        const FixedInteger<N>& b) const;
+        // x = a * a * R^-1 mod n. x may be a.
+        void square(FixedInteger<N>& x, const FixedInteger<N>& a) const;
+
+    private:
+        // Column accumulator arithmetic. The accumulator is acc plus
+        // high * 2^128.
+        static void add(uint128_t& acc, uint64_t& high, uint64_t a)
+                { acc += a; high += acc < a; }
+        static void mac(uint128_t& acc, uint64_t& high, uint64_t a, uint64_t b)
+                { uint128_t p = (uint128_t)a * b; acc += p; high += acc < p; }
+        static void shift(uint128_t& acc, uint64_t& high)
+                { acc = (acc >> 64) | ((uint128_t)high << 64); high = 0; }
+        void reduce(FixedInteger<N>& x, const uint64_t *t) const;
+        void subtract(FixedInteger<N>& x, const FixedInteger<N>& result,
+                                        uint64_t top) const;
+
+    private:
+        FixedInteger<N> n;
+        FixedInteger<N> r2;     // R^2 mod n
+        uint64_t n0;
+
+};
+
+/*
+ * Same windows as MontgomeryContext::modPow. Exponents of more than
+ * 64 bits get a multiplication for every window, zero or not, and the
+ * table entry is selected without indexing by the window.
+ */
+template<unsigned N>
+void FixedMontgomery<N>::modPow(FixedInteger<N>& x, const FixedInteger<N>& base,
+                                        const FixedInteger<N>& exp) const {
+
+    long bits = exp.bitLength();
+    long w = bits > 512 ? 5 : (bits > 64 ? 4 : 1);
+
+    FixedInteger<N> one;
+    one[0] = 1;
+    FixedInteger<N> table[32];
+    multiply(table[0], one, r2);
+    multiply(table[1], base, r2);
+    for (unsigned i = 2; i < (1U << w); ++i) {
+        multiply(table[i], table[i - 1], table[1]);
+    }
+
+    FixedInteger<N> result(table[0]);
+    for (long i = ((bits + w - 1) / w) * w - w; i >= 0; i -= w) {
+        for (long j = 0; j < w; ++j) {
+            square(result, result);
+        }
+        unsigned window = 0;
+        for (long j = w - 1; j >= 0; --j) {
+            window = (window << 1) | exp.bit(i + j);
+        }
+        if (w > 1) {
+            // The window is secret. Every entry is read and the one
+            // wanted is kept by mask, so the memory accesses don't
+            // depend on it.
+            FixedInteger<N> entry;
+            for (unsigned t = 0; t < (1U << w); ++t) {
+                uint64_t d = t ^ window;
+                entry.select(table[t], ((d | (0 - d)) >> 63) - 1);
+            }
+            multiply(result, result, entry);
+        }
+        else if (window != 0) {
+            multiply(result, result, table[1]);
+        }
+    }
+
+    multiply(x, result, one);
+
+}
+
+/*
+ * Product scanning Montgomery multiplication. Each column of a * b
+ * and m * n is summed into a three limb accumulator, and the limb of
+ * m that clears the column is found as the column is finished. No
+ * intermediate product is stored.
+ */
+template<unsigned N>
+void FixedMontgomery<N>::multiply(FixedInteger<N>& x, const FixedInteger<N>& a,
+                                        const FixedInteger<N>& b) const {
+
+    uint64_t m[N];
+    uint128_t acc = 0;
+    uint64_t high = 0;
+    for (unsigned k = 0; k < N; ++k) {
+        for (unsigned i = 0; i < k; ++i) {
+            mac(acc, high, a[i], b[k - i]);
+            mac(acc, high, m[i], n[k - i]);
+        }
+        mac(acc, high, a[k], b[0]);
+        m[k] = (uint64_t)acc * n0;
+        mac(acc, high, m[k], n[0]);
+        shift(acc, high);
+    }
+
+    FixedInteger<N> result;
+    for (unsigned k = N; k < 2 * N; ++k) {
+        for (unsigned i = k - N + 1; i < N; ++i) {
+            mac(acc, high, a[i], b[k - i]);
+            mac(acc, high, m[i], n[k - i]);
+        }
+        result[k - N] = (uint64_t)acc;
+        shift(acc, high);
+    }
+    subtract(x, result, (uint64_t)acc);
+
+}
+
+/*
+ * x = t * R^-1 mod n, for the 2N limb t, by product scanning as in
+ * multiply.
+ */
+template<unsigned N>
+void FixedMontgomery<N>::reduce(FixedInteger<N>& x, const uint64_t *t) const {
+
+    uint64_t m[N];
+    uint128_t acc = 0;
+    uint64_t high = 0;
+    for (unsigned k = 0; k < N; ++k) {
+        add(acc, high, t[k]);
+        for (unsigned i = 0; i < k; ++i) {
+            mac(acc, high, m[i], n[k - i]);
+        }
+        m[k] = (uint64_t)acc * n0;
+        mac(acc, high, m[k], n[0]);
+        shift(acc, high);
+    }
+
+    FixedInteger<N> result;
+    for (unsigned k = N; k < 2 * N; ++k) {
+        add(acc, high, t[k]);
+        for (unsigned i = k - N + 1; i < N; ++i) {
+            mac(acc, high, m[i], n[k - i]);
+        }
+        result[k - N] = (uint64_t)acc;
+        shift(acc, high);
+    }
+    subtract(x, result, (uint64_t)acc);
+
+}
+
+/*
+ * The square is formed a column at a time. The cross products of a
+ * column are summed once and doubled before the square on the
+ * diagonal is added, which saves nearly half the limb products.
+ */
+template<unsigned N>
+void FixedMontgomery<N>::square(FixedInteger<N>& x, const FixedInteger<N>& a) const {
+
+    uint64_t t[2 * N];
+    uint128_t acc = 0;
+    uint64_t high = 0;
+    for (unsigned k = 0; k < 2 * N - 1; ++k) {
+        uint128_t cross = 0;
+        uint64_t crossHigh = 0;
+        for (unsigned i = k < N ? 0 : k - N + 1; i < k - i; ++i) {
+            mac(cross, crossHigh, a[i], a[k - i]);
+        }
+        crossHigh = (crossHigh << 1) | (uint64_t)(cross >> 127);
+        cross = cross << 1;
+        acc += cross;
+        high += crossHigh + (acc < cross);
+        if ((k & 1) == 0) {
+            mac(acc, high, a[k / 2], a[k / 2]);
+        }
+        t[k] = (uint64_t)acc;
+        shift(acc, high);
+    }
+    t[2 * N - 1] = (uint64_t)acc;
+    reduce(x, t);
+
+}
+
+/*
+ * The result is less than 2n. Keep the difference unless it went
+ * negative, which is when the borrow isn't matched by the top bit.
+ */
+template<unsigned N>
+void FixedMontgomery<N>::subtract(FixedInteger<N>& x, const FixedInteger<N>& result,
+                                        uint64_t top) const {
+
+    FixedInteger<N> d(result);
+    uint64_t borrow = d.subtract(n);
+    x = result;
+    x.select(d, 0 - (uint64_t)(borrow == top));
+
+}
+
+}
+
+#endif  // FIXEDMONTGOMERY_H_INCLUDED
@@ -0,0 +1,41 @@
+#ifndef MAPPEDFILE_H_INCLUDED
+#define MAPPEDFILE_H_INCLUDED
+
+#include <string>
+#include <cstdint>
+
+namespace CK {
+
+/*
+ * Read only memory mapping of a whole file. The kernel is advised
+ * that the mapping will be read sequentially, so pages are read
+ * ahead and dropped behind. The mapping is removed when the object
+ * is destroyed.
+ *
+ * Only regular files can be mapped. Anything else throws
+ * BadParameterException.
+ */
+class MappedFile {
+
+    public:
+        MappedFile(const std::string& path);
+        ~MappedFile();
+
+    private:
+        MappedFile(const MappedFile& other);
+        MappedFile& operator= (const MappedFile& other);
+
+    public:
+        // Null for an empty file.
+        const uint8_t *getData() const { return data; }
+        uint64_t getLength() const { return length; }
+
+    private:
+        uint8_t *data;
+        uint64_t length;
+
+};
+
+}
+
+#endif // MAPPEDFILE_H_INCLUDED
@@ -0,0 +1,77 @@
+#ifndef MONTGOMERYCONTEXT_H_INCLUDED
+#define MONTGOMERYCONTEXT_H_INCLUDED
+
+#include <cstdint>
+#include <deque>
+
+namespace NTL {
+    class ZZ;
+}
+
+namespace CK {
+
+class BigInteger;
+
+/*
+ * Montgomery modular arithmetic for a fixed odd modulus n.
+ *
+ * The reduction constants are computed once, when the context is
+ * made. Every modular multiplication after that is three integer
+ * multiplications, two truncations and a shift. Nothing is divided.
+ * RSA keys keep a context for each modulus they exponentiate with, so
+ * repeated operations with the same key skip the setup.
+ *
+ * Moduli of 16 or 24 limbs, the CRT primes of 2048 and 3072 bit RSA
+ * keys, are also kept as fixed width limbs and exponentiated with
+ * FixedMontgomery.
+ *
+ * An even modulus has no Montgomery form. Contexts for one fall back
+ * to BigInteger::modPow.
+ */
+class MontgomeryContext {
+
+    private:
+        MontgomeryContext();
+
+    public:
+        typedef std::deque<BigInteger> Integers;
+
+    public:
+        MontgomeryContext(const BigInteger& modulus);
+        MontgomeryContext(const MontgomeryContext& other);
+        MontgomeryContext& operator= (const MontgomeryContext& other);
+        ~MontgomeryContext();
+
+    public:
+        // Returns base^exp mod n. Safe to call from several threads.
+        // Private exponents don't select table entries by index or
+        // subtract n depending on a value. Above the fixed widths, NTL's
+        // own arithmetic still takes time that varies with the lengths
+        // of the values it is given.
+        BigInteger modPow(const BigInteger& base, const BigInteger& exp) const;
+        // Returns base^exp mod n for each of the bases.
+        Integers modPow(const Integers& bases, const BigInteger& exp) const;
+
+    private:
+        template<unsigned N>
+        void fixedModPow(const Integers& bases, const BigInteger& exp,
+                                                    Integers& results) const;
+        BigInteger ntlModPow(const BigInteger& base, const BigInteger& exp) const;
+        void multiply(NTL::ZZ& x, const NTL::ZZ& a, const NTL::ZZ& b,
+                                            NTL::ZZ& t, NTL::ZZ& m) const;
+
+    private:
+        NTL::ZZ *n;
+        NTL::ZZ *nPrime;        // -n^-1 mod R
+        NTL::ZZ *r2;            // R^2 mod n
+        long k;                 // R = 2^k > 4n
+        bool odd;
+        unsigned limbs;
+        uint64_t *words;        // n and 2^(128 limbs) mod n, for the fixed widths
+        uint64_t n0;            // -n^-1 mod 2^64
+
+};
+
+}
+
+#endif  // MONTGOMERYCONTEXT_H_INCLUDED
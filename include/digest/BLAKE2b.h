@@ -0,0 +1,57 @@
+#ifndef BLAKE2B_H_INCLUDED
+#define BLAKE2B_H_INCLUDED
+
+#include "DigestBase.h"
+
+namespace CK {
+
+/*
+ * BLAKE2b message digest implementation. See RFC 7693.
+ *
+ * The digest length is 1 to 64 bytes. Keyed hashing is not
+ * supported; use HMAC.
+ */
+class BLAKE2b : public DigestBase {
+
+    public:
+        BLAKE2b(unsigned length = 64);
+        ~BLAKE2b();
+
+    private:
+        BLAKE2b(const BLAKE2b& other);
+        BLAKE2b& operator= (const BLAKE2b& other);
+
+    public:
+        Digest *clone() const;
+        uint32_t getBlockSize() const { return 128; }
+        uint32_t getDigestLength() const { return length; }
+
+    protected:
+        void compress(const uint8_t *chunk);
+        void copyState(const DigestBase& other);
+        void finalize(uint8_t *out);
+        const coder::ByteArray& getDER() const { return DER; }
+        void initialize();
+
+    private:
+        void G(uint64_t *v, int a, int b, int c, int d, uint64_t x, uint64_t y) const;
+        void mix(const uint8_t *block, bool last);
+        uint64_t ror(uint64_t reg, int count) const;
+
+    private:
+        unsigned length;        // Digest length in bytes
+        uint64_t H[8];          // Hash state
+        uint64_t t;             // Bytes compressed
+
+        // Initialization vector
+        static const uint64_t IV[8];
+        // Message word permutations
+        static const uint8_t SIGMA[10][16];
+        // No ASN.1 identifier.
+        static const coder::ByteArray DER;
+
+};
+
+}
+
+#endif  // BLAKE2B_H_INCLUDED
@@ -0,0 +1,57 @@
+#ifndef BLAKE2S_H_INCLUDED
+#define BLAKE2S_H_INCLUDED
+
+#include "DigestBase.h"
+
+namespace CK {
+
+/*
+ * BLAKE2s message digest implementation. See RFC 7693.
+ *
+ * The digest length is 1 to 32 bytes. Keyed hashing is not
+ * supported; use HMAC.
+ */
+class BLAKE2s : public DigestBase {
+
+    public:
+        BLAKE2s(unsigned length = 32);
+        ~BLAKE2s();
+
+    private:
+        BLAKE2s(const BLAKE2s& other);
+        BLAKE2s& operator= (const BLAKE2s& other);
+
+    public:
+        Digest *clone() const;
+        uint32_t getBlockSize() const { return 64; }
+        uint32_t getDigestLength() const { return length; }
+
+    protected:
+        void compress(const uint8_t *chunk);
+        void copyState(const DigestBase& other);
+        void finalize(uint8_t *out);
+        const coder::ByteArray& getDER() const { return DER; }
+        void initialize();
+
+    private:
+        void G(uint32_t *v, int a, int b, int c, int d, uint32_t x, uint32_t y) const;
+        void mix(const uint8_t *block, bool last);
+        uint32_t ror(uint32_t reg, int count) const;
+
+    private:
+        unsigned length;        // Digest length in bytes
+        uint32_t H[8];          // Hash state
+        uint64_t t;             // Bytes compressed
+
+        // Initialization vector
+        static const uint32_t IV[8];
+        // Message word permutations
+        static const uint8_t SIGMA[10][16];
+        // No ASN.1 identifier.
+        static const coder::ByteArray DER;
+
+};
+
+}
+
+#endif  // BLAKE2S_H_INCLUDED
@@ -0,0 +1,126 @@
+#ifndef BLAKE3_H_INCLUDED
+#define BLAKE3_H_INCLUDED
+
+#include "Digest.h"
+#include <string>
+
+namespace CK {
+
+/*
+ * BLAKE3 message digest implementation.
+ *
+ * The message is split into 1 KiB chunks that are the leaves of a
+ * binary hash tree. Runs of whole chunks are hashed several at a time,
+ * one chunk per SIMD lane, and large runs are split into subtrees that
+ * are hashed and merged on separate threads. The lane count is 16 with
+ * AVX-512, 8 with AVX2 and 4 otherwise.
+ *
+ * The digest length defaults to 32 bytes. Any length can be requested.
+ * Keyed hashing and key derivation are not supported.
+ *
+ * The ByteArray overloads copy the bytes once before hashing them. The
+ * memory range overloads and digestFile hash in place.
+ */
+class BLAKE3 : public Digest {
+
+    public:
+        BLAKE3(unsigned length = 32);
+        ~BLAKE3();
+
+    private:
+        BLAKE3(const BLAKE3& other);
+        BLAKE3& operator= (const BLAKE3& other);
+
+    public:
+        Digest *clone() const;
+        coder::ByteArray digest();
+        coder::ByteArray digest(const coder::ByteArray& bytes);
+        coder::ByteArray digest(const uint8_t *bytes, uint64_t count);
+        void digest(uint8_t *out);
+        coder::ByteArray digestFile(const std::string& path);
+        uint32_t getBlockSize() const { return 64; }
+        const coder::ByteArray& getDER() const { return DER; }
+        uint32_t getDigestLength() const { return length; }
+        void reset();
+        void restoreState(const Digest& snapshot);
+        void saveState(Digest& snapshot) const;
+        // 0 uses one thread per hardware thread.
+        void setThreads(unsigned t);
+        void update(uint8_t byte);
+        void update(const coder::ByteArray& bytes);
+        void update(const coder::ByteArray& bytes, uint32_t offset, uint32_t count);
+        void update(const uint8_t *bytes, uint64_t count);
+
+    private:
+        static const unsigned CHUNK_LEN = 1024;
+        static const unsigned MAX_DEPTH = 55;       // 2^64 bytes, one unmerged
+        static const unsigned MAX_LANES = 16;
+        // Fewest chunks worth a thread of their own.
+        static const uint64_t MIN_THREAD_CHUNKS = 256;
+
+        // Domain flags
+        static const uint32_t CHUNK_START = 1;
+        static const uint32_t CHUNK_END = 2;
+        static const uint32_t PARENT = 4;
+        static const uint32_t ROOT = 8;
+
+        // The inputs of a compression that hasn't been done yet. The
+        // root node is kept this way until the output length is known.
+        struct Output {
+            uint32_t cv[8];
+            uint32_t block[16];
+            uint64_t counter;
+            uint32_t blockLen;
+            uint32_t flags;
+        };
+
+        // Chaining values, lane minor.
+        typedef uint32_t LaneCV[8][MAX_LANES];
+        typedef void (*Kernel)(const uint8_t *chunks, uint64_t counter, LaneCV& cvs);
+
+    private:
+        static void chunkCV(const uint8_t *chunk, uint64_t counter, uint32_t *cv);
+        void chunkOutput(Output& out) const;
+        void chunkUpdate(const uint8_t *bytes, unsigned count);
+        static void compress(const uint32_t *cv, const uint32_t *block, uint64_t counter,
+                                    uint32_t blockLen, uint32_t flags, uint32_t *out);
+        static void hash4(const uint8_t *chunks, uint64_t counter, LaneCV& cvs);
+        static void hash8(const uint8_t *chunks, uint64_t counter, LaneCV& cvs);
+        static void hash16(const uint8_t *chunks, uint64_t counter, LaneCV& cvs);
+        void mergeStack(uint64_t total);
+        static void parentCV(const uint32_t *left, const uint32_t *right, uint32_t *cv);
+        void pushCV(const uint32_t *cv, uint64_t total);
+        void subtree(const uint8_t *chunks, uint64_t count, uint64_t counter,
+                                                            uint32_t *cv) const;
+        void subtreeThread(const uint8_t *chunks, uint64_t count, uint64_t counter,
+                                                            uint32_t *cv) const;
+
+    private:
+        unsigned length;            // Digest length in bytes
+        unsigned threads;
+        unsigned lanes;
+        Kernel kernel;
+
+        // Current chunk
+        uint32_t cv[8];
+        uint64_t chunkCounter;
+        uint8_t block[64];
+        unsigned blockLen;
+        unsigned blocksCompressed;
+
+        // Chaining values of completed subtrees, largest first.
+        uint32_t stack[MAX_DEPTH][8];
+        unsigned stackSize;
+
+        // Initialization vector
+        static const uint32_t IV[8];
+        // Message word schedule for each round.
+        static const uint8_t SCHEDULE[7][16];
+        // No ASN.1 identifier.
+        static const coder::ByteArray DER;
+
+};
+
+}
+
+#endif  // BLAKE3_H_INCLUDED
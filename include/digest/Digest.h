@@ -23,23 +23,31 @@ class Digest {
         virtual ~Digest() {}
 
     public:
+        // Return a new digest with a copy of this digest's state.
+        virtual Digest *clone() const=0;
         virtual coder::ByteArray digest()=0;
         virtual coder::ByteArray digest(const coder::ByteArray& bytes)=0;
+        // Complete the digest into a buffer of getDigestLength() bytes.
+        virtual void digest(uint8_t *out)=0;
+        // One step hash of a file. Accumulated updates are lost.
+        virtual coder::ByteArray digestFile(const std::string& path)=0;
         virtual uint32_t getBlockSize() const=0; // Used for HMAC
         virtual const coder::ByteArray& getDER() const=0;
         virtual uint32_t getDigestLength() const=0;
         virtual void reset()=0;
+        // Replace this digest's state with the snapshot's state.
+        virtual void restoreState(const Digest& snapshot)=0;
+        // Copy this digest's state into the snapshot.
+        virtual void saveState(Digest& snapshot) const=0;
         virtual void update(uint8_t byte)=0;
         virtual void update(const coder::ByteArray& bytes)=0;
         virtual void update(const coder::ByteArray& bytes, uint32_t offset,
                                         uint32_t length)=0;
+        virtual void update(const uint8_t *bytes, uint64_t length)=0;
 
     public:
         static Digest *getInstance(const std::string& algorithm);
 
-    protected:
-        virtual coder::ByteArray finalize(const coder::ByteArray& bytes) const=0;
-
 };
 
 }
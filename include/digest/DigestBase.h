@@ -10,13 +10,21 @@ namespace CK {
  * Digest base implementation class.
  * The class is abstract. Also includes a convenience method
  * for creating instances by name.
+ *
+ * Updates are buffered one chunk at a time. Each full chunk is
+ * compressed into the hash state as soon as more input arrives, so
+ * memory use doesn't depend on the message length.
+ *
+ * The intermediate state can be copied to another digest of the same
+ * algorithm, so a common prefix can be hashed once and reused.
  */
 class DigestBase : public Digest {
 
     protected:
-        DigestBase();
+        DigestBase(unsigned chunkSize);
 
     private:
+        DigestBase();
         DigestBase(const DigestBase& other);
         DigestBase& operator= (const DigestBase& other);
 
@@ -26,16 +34,43 @@ class DigestBase : public Digest {
     public:
         coder::ByteArray digest();
         coder::ByteArray digest(const coder::ByteArray& bytes);
+        void digest(uint8_t *out);
+        coder::ByteArray digestFile(const std::string& path);
         void reset();
+        void restoreState(const Digest& snapshot);
+        void saveState(Digest& snapshot) const;
         void update(uint8_t byte);
         void update(const coder::ByteArray& bytes);
         void update(const coder::ByteArray& bytes, uint32_t offset, uint32_t length);
+        void update(const uint8_t *bytes, uint64_t length);
 
     public:
         static Digest* getInstance(const std::string& algorithm);
 
+    protected:
+        // Process one chunk into the hash state.
+        virtual void compress(const uint8_t *chunk)=0;
+        // Copy the hash state of a digest of the same class.
+        virtual void copyState(const DigestBase& other)=0;
+        // Pad the last chunk and write the hash value to out.
+        virtual void finalize(uint8_t *out)=0;
+        // Set the initial hash state.
+        virtual void initialize()=0;
+        // Zero fill the buffered chunk and return it for final processing.
+        const uint8_t *lastChunk(unsigned& count);
+        // Merkle-Damgard padding with a lengthSize byte bit count.
+        void pad(unsigned lengthSize);
+
+    protected:
+        uint64_t messageLength;     // Bytes hashed so far.
+
     private:
-        coder::ByteArray accumulator;
+        static const unsigned MAX_CHUNK = 168;      // SHAKE128 rate
+        static const unsigned MAX_DIGEST = 64;      // Fixed length digests
+
+        unsigned chunkSize;
+        uint8_t chunk[MAX_CHUNK];
+        unsigned fill;              // Bytes in the chunk buffer.
 
 };
 
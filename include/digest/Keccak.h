@@ -0,0 +1,60 @@
+#ifndef KECCAK_H_INCLUDED
+#define KECCAK_H_INCLUDED
+
+#include "DigestBase.h"
+
+namespace CK {
+
+/*
+ * Keccak sponge construction. See FIPS 202.
+ *
+ * Base class for SHA-3 and SHAKE. Input is absorbed one rate sized
+ * block at a time through the base class chunk buffer. The state is
+ * kept with six lanes complemented, which saves most of the NOT
+ * operations in the chi step. The complement is applied when the
+ * state is cleared and removed when output is squeezed.
+ */
+class Keccak : public DigestBase {
+
+    protected:
+        Keccak(unsigned rate, uint8_t domain);
+
+    private:
+        Keccak();
+        Keccak(const Keccak& other);
+        Keccak& operator= (const Keccak& other);
+
+    public:
+        virtual ~Keccak();
+
+    protected:
+        void compress(const uint8_t *chunk);
+        void copyState(const DigestBase& other);
+        // Squeeze count more output bytes. The first call ends absorption.
+        void extract(uint8_t *out, unsigned count);
+        void finalize(uint8_t *out);
+        void initialize();
+
+    private:
+        void absorb(const uint8_t *block);
+        void padAbsorb();
+        void permute();
+        static void round(const uint64_t *S, uint64_t *E, uint64_t rc);
+
+    private:
+        unsigned rate;          // Bytes per block
+        uint8_t domain;         // Domain separation and first pad bits
+        uint64_t A[25];         // State, lane x + 5y
+        unsigned offset;        // Output bytes taken from the current block
+        bool squeezing;
+
+        // Iota round constants
+        static const uint64_t RC[24];
+        // Lanes that are stored complemented.
+        static const uint64_t COMPLEMENT[25];
+
+};
+
+}
+
+#endif  // KECCAK_H_INCLUDED
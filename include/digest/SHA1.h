@@ -16,23 +16,29 @@ class SHA1 : public DigestBase {
         SHA1& operator= (const SHA1& other);
 
     public:
-        uint32_t getBlockSize() const { return 20; }
+        Digest *clone() const;
+        uint32_t getBlockSize() const { return 64; }
         uint32_t getDigestLength() const { return 20; }
 
     protected:
-        coder::ByteArray finalize(const coder::ByteArray& bytes) const;
+        void compress(const uint8_t *chunk);
+        void copyState(const DigestBase& other);
+        void finalize(uint8_t *out);
         const coder::ByteArray& getDER() const { return DER; }
+        void initialize();
 
     private:
         uint32_t Ch(uint32_t x, uint32_t y, uint32_t z) const;
+        void compressSHA(const uint8_t *chunk);
         uint32_t f(uint32_t x, uint32_t y, uint32_t z, uint32_t t) const;
         uint32_t Maj(uint32_t x, uint32_t y, uint32_t z) const;
-        coder::ByteArray pad(const coder::ByteArray& in) const;
         uint32_t Parity(uint32_t x, uint32_t y, uint32_t z) const;
         uint32_t rol(uint32_t x, int count) const;
-        uint32_t *W(const coder::ByteArray& chunk) const;
+        uint32_t schedule(uint32_t *w, int t) const;
 
     private:
+        uint32_t H[5];          // Hash state
+
         static const uint32_t H1;
         static const uint32_t H2;
         static const uint32_t H3;
@@ -42,6 +48,8 @@ class SHA1 : public DigestBase {
         static const uint32_t K[];
 
         static const coder::ByteArray DER;
+        // Use the Intel SHA extensions.
+        static const bool shaExtensions;
 
 };
 
@@ -0,0 +1,43 @@
+#ifndef SHA224_H_INCLUDED
+#define SHA224_H_INCLUDED
+
+#include "SHA256.h"
+
+namespace CK {
+
+/*
+ * SHA-224 message digest implementation.
+ *
+ * SHA-224 is SHA-256 with a different initial hash value and the
+ * result truncated to 224 bits.
+ */
+class SHA224 : public SHA256 {
+
+    public:
+        SHA224();
+        ~SHA224();
+
+    private:
+        SHA224(const SHA224& other);
+        SHA224& operator= (const SHA224& other);
+
+    public:
+        Digest *clone() const;
+        uint32_t getDigestLength() const { return 28; }
+
+    protected:
+        const coder::ByteArray& getDER() const;
+        void initialize();
+
+    private:
+        // Hash constants
+        static const uint32_t H1, H2, H3, H4,
+                                H5, H6, H7, H8;
+        // ASN.1 identifier encoding.
+        static const coder::ByteArray DER;
+
+};
+
+}
+
+#endif  // SHA224_H_INCLUDED
@@ -2,7 +2,6 @@
 #define SHA256_H_INCLUDED
 
 #include "DigestBase.h"
-#include <deque>
 
 namespace CK {
 
@@ -11,6 +10,10 @@ namespace CK {
  */
 class SHA256 : public DigestBase {
 
+    private:
+        friend class HMACBatch;
+        friend class SHA256Batch;
+
     public:
         SHA256();
         ~SHA256();
@@ -20,30 +23,34 @@ class SHA256 : public DigestBase {
         SHA256& operator= (const SHA256& other);
 
     public:
+        Digest *clone() const;
         uint32_t getBlockSize() const { return 64; }
         uint32_t getDigestLength() const { return 32; }
 
     protected:
-        coder::ByteArray finalize(const coder::ByteArray& bytes) const;
+        void compress(const uint8_t *chunk);
+        void copyState(const DigestBase& other);
+        void finalize(uint8_t *out);
         const coder::ByteArray& getDER() const;
-
-    private:
-        typedef std::deque<uint32_t> W;
+        void initialize();
 
     private:
         uint32_t Ch(uint32_t x, uint32_t y, uint32_t z) const;
-        W decompose(const coder::ByteArray& chunks) const;
+        void compressSHA(const uint8_t *chunk);
         uint32_t Maj(uint32_t x, uint32_t y, uint32_t z) const;
-        coder::ByteArray pad(const coder::ByteArray& in) const;
         uint32_t ror(uint32_t reg, int count) const;
+        void round(uint32_t a, uint32_t b, uint32_t c, uint32_t& d, uint32_t e,
+                    uint32_t f, uint32_t g, uint32_t& h, uint32_t kw) const;
+        uint32_t schedule(uint32_t *w, int j) const;
         uint32_t sigma0(uint32_t w) const;
         uint32_t sigma1(uint32_t w) const;
         uint32_t Sigma0(uint32_t w) const;
         uint32_t Sigma1(uint32_t w) const;
 
-    private:
-        typedef std::deque<coder::ByteArray> Chunks;
+    protected:
+        uint32_t H[8];          // Hash state
 
+    private:
         // Hash constants
         static const uint32_t H1, H2, H3, H4,
                                 H5, H6, H7, H8;
@@ -51,6 +58,8 @@ class SHA256 : public DigestBase {
         static const uint32_t K[];
         // ASN.1 identifier encoding.
         static const coder::ByteArray DER;
+        // Use the Intel SHA extensions.
+        static const bool shaExtensions;
 
 };
 
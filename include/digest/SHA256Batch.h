@@ -0,0 +1,75 @@
+#ifndef SHA256BATCH_H_INCLUDED
+#define SHA256BATCH_H_INCLUDED
+
+#include "coder/ByteArray.h"
+#include <deque>
+#include <cstdint>
+
+namespace CK {
+
+/*
+ * Multi-buffer SHA-256.
+ *
+ * Hashes many independent messages at once, one message per SIMD
+ * lane. The lane count is 16 with AVX-512, 8 with AVX2 and 4
+ * otherwise. Short messages gain the most since the per call cost
+ * is shared by every lane.
+ */
+class SHA256Batch {
+
+    private:
+        friend class HMACBatch;
+
+    public:
+        SHA256Batch();
+        ~SHA256Batch();
+
+    private:
+        SHA256Batch(const SHA256Batch& other);
+        SHA256Batch& operator= (const SHA256Batch& other);
+
+    public:
+        typedef std::deque<coder::ByteArray> Messages;
+        typedef std::deque<coder::ByteArray> Digests;
+
+    public:
+        // Returns one digest per message, in message order.
+        Digests digest(const Messages& messages);
+        unsigned getLanes() const { return lanes; }
+
+    private:
+        static const unsigned MAX_LANES = 16;
+
+        // One message to hash. The message is appended to a hash
+        // state that has already absorbed prefix bytes.
+        struct Job {
+            const uint8_t *message;
+            uint64_t length;
+            const uint32_t *iv;
+            uint64_t prefix;
+            uint8_t *out;       // 32 bytes
+        };
+
+        // Hash state and message words, lane minor.
+        typedef uint32_t LaneState[8][MAX_LANES];
+        typedef uint32_t LaneBlock[16][MAX_LANES];
+        typedef void (*Kernel)(LaneState& state, const LaneBlock& block);
+
+    private:
+        static void compress4(LaneState& state, const LaneBlock& block);
+        static void compress8(LaneState& state, const LaneBlock& block);
+        static void compress16(LaneState& state, const LaneBlock& block);
+        void fillBlock(const Job& job, uint64_t index, uint64_t blocks,
+                                                LaneBlock& block, unsigned lane) const;
+        static uint8_t *loadMessages(const Messages& messages, Job *jobs);
+        void run(Job *jobs, unsigned count);
+
+    private:
+        unsigned lanes;
+        Kernel kernel;
+
+};
+
+}
+
+#endif  // SHA256BATCH_H_INCLUDED
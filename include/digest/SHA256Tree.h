@@ -0,0 +1,61 @@
+#ifndef SHA256TREE_H_INCLUDED
+#define SHA256TREE_H_INCLUDED
+
+#include "coder/ByteArray.h"
+#include <string>
+#include <cstdint>
+
+namespace CK {
+
+/*
+ * Parallel Merkle tree hash over SHA-256.
+ *
+ * The input is split into leaves of a fixed size. The last leaf may
+ * be short. The tree is the RFC 6962 Merkle Tree Hash:
+ *
+ *   leaf hash  = SHA-256(0x00 || leaf)
+ *   node hash  = SHA-256(0x01 || left || right)
+ *
+ * For n > 1 leaves the left subtree holds the largest power of 2
+ * that is less than n leaves, the right subtree holds the rest. A
+ * single leaf is its own root. Empty input hashes to SHA-256 of the
+ * empty string.
+ *
+ * The result depends on the leaf size, so it is part of the hash
+ * definition. Leaves are hashed on up to the given number of threads.
+ *
+ * Hashing a ByteArray is a convenience that copies the whole input
+ * first. Large inputs should be passed as a memory range or a file,
+ * which are hashed in place.
+ */
+class SHA256Tree {
+
+    public:
+        // Leaf size in bytes, maximum threads, 0 for one per hardware
+        // thread.
+        SHA256Tree(unsigned leafSize = 1024 * 1024, unsigned threads = 0);
+        ~SHA256Tree();
+
+    private:
+        SHA256Tree(const SHA256Tree& other);
+        SHA256Tree& operator= (const SHA256Tree& other);
+
+    public:
+        coder::ByteArray digest(const coder::ByteArray& bytes);
+        coder::ByteArray digest(const uint8_t *bytes, uint64_t length);
+        coder::ByteArray digestFile(const std::string& path);
+        unsigned getLeafSize() const { return leafSize; }
+
+    private:
+        void hashLeaves(const uint8_t *bytes, uint64_t length, uint64_t first,
+                                    uint64_t count, uint8_t (*hashes)[32]) const;
+
+    private:
+        unsigned leafSize;
+        unsigned threads;
+
+};
+
+}
+
+#endif  // SHA256TREE_H_INCLUDED
@@ -0,0 +1,45 @@
+#ifndef SHA3_H_INCLUDED
+#define SHA3_H_INCLUDED
+
+#include "Keccak.h"
+
+namespace CK {
+
+/*
+ * SHA-3 message digest implementation. See FIPS 202.
+ *
+ * The digest length in bytes selects the algorithm: 28, 32, 48 or 64
+ * for SHA3-224, SHA3-256, SHA3-384 and SHA3-512.
+ */
+class SHA3 : public Keccak {
+
+    public:
+        SHA3(unsigned length = 32);
+        ~SHA3();
+
+    private:
+        SHA3(const SHA3& other);
+        SHA3& operator= (const SHA3& other);
+
+    public:
+        Digest *clone() const;
+        uint32_t getBlockSize() const { return 200 - (2 * length); }
+        uint32_t getDigestLength() const { return length; }
+
+    protected:
+        const coder::ByteArray& getDER() const;
+
+    private:
+        unsigned length;
+
+        // ASN.1 identifier encodings.
+        static const coder::ByteArray DER224;
+        static const coder::ByteArray DER256;
+        static const coder::ByteArray DER384;
+        static const coder::ByteArray DER512;
+
+};
+
+}
+
+#endif  // SHA3_H_INCLUDED
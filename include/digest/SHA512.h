@@ -3,12 +3,13 @@
 
 #include "DigestBase.h"
 
-#include <deque>
-
 namespace CK {
         
 /*
  * SHA-512 message digest implementation.
+ *
+ * SHA-384 uses the same compression function. It derives from this
+ * class and supplies its own initial hash value and digest length.
  */
 class SHA512 : public DigestBase {
 
@@ -21,30 +22,34 @@ class SHA512 : public DigestBase {
         SHA512& operator= (const SHA512& other);
 
     public:
-        uint32_t getBlockSize() const { return 64; }
+        Digest *clone() const;
+        uint32_t getBlockSize() const { return 128; }
         uint32_t getDigestLength() const { return 64; }
 
     protected:
-        coder::ByteArray finalize(const coder::ByteArray& bytes) const;
+        void compress(const uint8_t *chunk);
+        void copyState(const DigestBase& other);
+        void finalize(uint8_t *out);
         const coder::ByteArray& getDER() const;
+        void initialize();
 
-    private:
-        typedef std::deque<uint64_t> W;
-        
     private:
         uint64_t Ch(uint64_t x, uint64_t y, uint64_t z) const;
-        W decompose(const coder::ByteArray& chunks) const;
+        void expand(uint64_t *w) const;
+        void expandAVX2(uint64_t *w) const;
         uint64_t Maj(uint64_t x, uint64_t y, uint64_t z) const;
-        coder::ByteArray pad(const coder::ByteArray& in) const;
         uint64_t ror(uint64_t reg, int count) const;
+        void round(uint64_t a, uint64_t b, uint64_t c, uint64_t& d, uint64_t e,
+                    uint64_t f, uint64_t g, uint64_t& h, uint64_t kw) const;
         uint64_t sigma0(uint64_t w) const;
         uint64_t sigma1(uint64_t w) const;
         uint64_t Sigma0(uint64_t w) const;
         uint64_t Sigma1(uint64_t w) const;
 
-    private:
-        typedef std::deque<coder::ByteArray> Chunks;
+    protected:
+        uint64_t H[8];          // Hash state
 
+    private:
         // Hash constants
         static const uint64_t H1, H2, H3, H4,
                                 H5, H6, H7, H8;
@@ -52,6 +57,8 @@ class SHA512 : public DigestBase {
         static const uint64_t K[];
         // ASN.1 identifier encoding.
         static const coder::ByteArray DER;
+        // Expand the message schedule with AVX2.
+        static const bool avx2;
 
 };
 
@@ -0,0 +1,44 @@
+#ifndef SHA512_256_H_INCLUDED
+#define SHA512_256_H_INCLUDED
+
+#include "SHA512.h"
+
+namespace CK {
+
+/*
+ * SHA-512/256 message digest implementation. See FIPS 180-4.
+ *
+ * SHA-512/256 is SHA-512 with a different initial hash value and the
+ * result truncated to 256 bits. It has the strength of SHA-256 and
+ * is faster on 64 bit processors.
+ */
+class SHA512_256 : public SHA512 {
+
+    public:
+        SHA512_256();
+        ~SHA512_256();
+
+    private:
+        SHA512_256(const SHA512_256& other);
+        SHA512_256& operator= (const SHA512_256& other);
+
+    public:
+        Digest *clone() const;
+        uint32_t getDigestLength() const { return 32; }
+
+    protected:
+        const coder::ByteArray& getDER() const;
+        void initialize();
+
+    private:
+        // Hash constants
+        static const uint64_t H1, H2, H3, H4,
+                                H5, H6, H7, H8;
+        // ASN.1 identifier encoding.
+        static const coder::ByteArray DER;
+
+};
+
+}
+
+#endif  // SHA512_256_H_INCLUDED
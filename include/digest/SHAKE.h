@@ -0,0 +1,48 @@
+#ifndef SHAKE_H_INCLUDED
+#define SHAKE_H_INCLUDED
+
+#include "Keccak.h"
+
+namespace CK {
+
+/*
+ * SHAKE extendable output function. See FIPS 202.
+ *
+ * The security strength is 128 or 256 bits. digest() returns the
+ * default output length. squeeze() returns any amount of output, in
+ * as many calls as needed, and can stand in for MGF1 as a mask
+ * generator: update with the seed and squeeze the mask length.
+ * Updates after the first squeeze are ignored until the next reset.
+ */
+class SHAKE : public Keccak {
+
+    public:
+        SHAKE(unsigned strength = 128, unsigned length = 32);
+        ~SHAKE();
+
+    private:
+        SHAKE(const SHAKE& other);
+        SHAKE& operator= (const SHAKE& other);
+
+    public:
+        Digest *clone() const;
+        uint32_t getBlockSize() const { return 200 - (strength / 4); }
+        uint32_t getDigestLength() const { return length; }
+        coder::ByteArray squeeze(unsigned count);
+        void squeeze(uint8_t *out, unsigned count);
+
+    protected:
+        const coder::ByteArray& getDER() const { return DER; }
+
+    private:
+        unsigned strength;
+        unsigned length;
+
+        // No ASN.1 identifier.
+        static const coder::ByteArray DER;
+
+};
+
+}
+
+#endif  // SHAKE_H_INCLUDED
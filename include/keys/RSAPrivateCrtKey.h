@@ -3,6 +3,7 @@
 
 #include "RSAPrivateKey.h"
 #include "../data/BigInteger.h"
+#include "../data/MontgomeryContext.h"
 
 namespace CK {
 
@@ -30,13 +31,23 @@ class RSAPrivateCrtKey : public RSAPrivateKey {
         const BigInteger& getPrimeQ() const;
         const BigInteger& getPrivateExponent() const { return d; }
         void setModulus(const BigInteger& mod) { n = mod; }
+        // Run the two CRT exponentiations on separate threads.
+        void setParallel(bool p) { parallel = p; }
         void setPrivateExponent(const BigInteger& exp) { d = exp; }
 
     protected:
         // Decryption primitive.
         BigInteger rsadp(const BigInteger& c) const;
+        Representatives rsadp(const Representatives& c) const;
         // Signature generation primitive.
         BigInteger rsasp1(const BigInteger& m) const;
+        Representatives rsasp1(const Representatives& m) const;
+
+    private:
+        // x_1 = x^dP mod p and x_2 = x^dQ mod q.
+        void exponentiate(const BigInteger& x, BigInteger& x_1, BigInteger& x_2) const;
+        void exponentiate(const Representatives& x, Representatives& x_1,
+                                                    Representatives& x_2) const;
 
     private:
         BigInteger p;  // First prime.
@@ -46,6 +57,9 @@ class RSAPrivateCrtKey : public RSAPrivateKey {
         BigInteger qInv;    // qInv
         BigInteger d;       // Private exponent
         BigInteger n; // Modulus
+        MontgomeryContext pContext;
+        MontgomeryContext qContext;
+        bool parallel;
 
 };
 
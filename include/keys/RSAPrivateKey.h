@@ -3,6 +3,7 @@
 
 #include "PrivateKey.h"
 #include "../data/BigInteger.h"
+#include <deque>
 
 namespace CK {
 
@@ -10,6 +11,7 @@ class RSAPrivateKey : public PrivateKey {
 
     public:
         enum KeyType { crt, mod };
+        typedef std::deque<BigInteger> Representatives;
 
     private:
         RSAPrivateKey();
@@ -34,8 +36,12 @@ class RSAPrivateKey : public PrivateKey {
         friend class OAEPrsaes;
         // Decryption primitive.
         virtual BigInteger rsadp(const BigInteger& c) const=0;
+        // Decryption primitive for a batch of representatives.
+        virtual Representatives rsadp(const Representatives& c) const=0;
         // Signature generation primitive.
         virtual BigInteger rsasp1(const BigInteger& m) const=0;
+        // Signature generation primitive for a batch of representatives.
+        virtual Representatives rsasp1(const Representatives& m) const=0;
 
     protected:
         int bitLength;
@@ -3,6 +3,7 @@
 
 #include "RSAPrivateKey.h"
 #include "../data/BigInteger.h"
+#include "../data/MontgomeryContext.h"
 
 namespace CK {
 
@@ -24,12 +25,15 @@ class RSAPrivateModKey : public RSAPrivateKey {
     protected:
         // Decryption primitive.
         BigInteger rsadp(const BigInteger& c) const;
+        Representatives rsadp(const Representatives& c) const;
         // Signature generation primitive.
         BigInteger rsasp1(const BigInteger& m) const;
+        Representatives rsasp1(const Representatives& m) const;
 
     private:
         BigInteger prvExp;  // d
         BigInteger mod; // n
+        MontgomeryContext modContext;
 
 };
 
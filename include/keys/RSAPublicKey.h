@@ -3,6 +3,7 @@
 
 #include "PublicKey.h"
 #include "../data/BigInteger.h"
+#include "../data/MontgomeryContext.h"
 
 namespace CK {
 
@@ -21,11 +22,14 @@ class RSAPublicKey : public PublicKey {
         int getBitLength() const;
         const BigInteger& getPublicExponent() const;
         const BigInteger& getModulus() const;
+        // Precomputed modular arithmetic for the modulus.
+        const MontgomeryContext& getModulusContext() const { return modContext; }
 
     private:
         BigInteger exp; // e
         BigInteger mod; // n
         int bitLength;
+        MontgomeryContext modContext;
 
 };
 
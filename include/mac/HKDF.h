@@ -0,0 +1,57 @@
+#ifndef HKDF_H_INCLUDED
+#define HKDF_H_INCLUDED
+
+#include "HMAC.h"
+#include <coder/ByteArray.h>
+
+namespace CK {
+
+class Digest;
+
+/*
+ * HMAC-based extract-and-expand key derivation function.
+ * See RFC 5869.
+ *
+ * extract() concentrates the input keying material into a pseudorandom
+ * key. expand() stretches a pseudorandom key into any number of output
+ * bytes, up to 255 digest lengths, bound to the context info. The
+ * pseudorandom key is set as the HMAC key once, so every expand block
+ * starts from the saved key states. Deriving several subkeys from one
+ * pseudorandom key with different info reuses the states.
+ */
+class HKDF {
+
+    private:
+        HKDF();
+
+    public:
+        HKDF(Digest *digest);
+        ~HKDF();
+
+    private:
+        HKDF(const HKDF& other);
+        HKDF& operator= (const HKDF& other);
+
+    public:
+        // Extract and expand in one step.
+        coder::ByteArray deriveKey(const coder::ByteArray& salt,
+                                        const coder::ByteArray& ikm,
+                                        const coder::ByteArray& info, unsigned length);
+        coder::ByteArray expand(const coder::ByteArray& prk,
+                                        const coder::ByteArray& info, unsigned length);
+        // Expand into a caller buffer of length bytes.
+        void expand(const coder::ByteArray& prk, const coder::ByteArray& info,
+                                        uint8_t *out, unsigned length);
+        // An empty salt is a digest length string of zeros.
+        coder::ByteArray extract(const coder::ByteArray& salt,
+                                        const coder::ByteArray& ikm);
+
+    private:
+        HMAC hmac;
+        unsigned L;
+
+};
+
+}
+
+#endif  // HKDF_H_INCLUDED
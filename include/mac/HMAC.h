@@ -11,9 +11,21 @@ class Digest;
 /*
  * Hash-based message authentication.
  * See RFC-2104 for details.
+ *
+ * The digest states after hashing the inner and outer padded keys
+ * are computed once per key. Each HMAC starts from copies of those
+ * states, so the key blocks aren't hashed again for every message.
+ *
+ * A message can be set whole with setMessage() and authenticated with
+ * getHMAC(), or fed in pieces with update() and finished with final().
+ * Updates go straight into the inner digest and aren't stored.
  */
 class HMAC : public JNIReference {
 
+    private:
+        friend class HKDF;
+        friend class PBKDF2;
+
     private:
         HMAC();
 
@@ -27,20 +39,39 @@ class HMAC : public JNIReference {
 
     public:
         bool authenticate(const coder::ByteArray& hmac);
+        // Complete a streamed HMAC. The next update starts a new message.
+        coder::ByteArray final();
+        // Complete a streamed HMAC into a buffer of getDigestLength() bytes.
+        void final(uint8_t *out);
         coder::ByteArray generateKey(unsigned bitsize);
         unsigned getDigestLength() const;
         coder::ByteArray getHMAC();
         void setKey(const coder::ByteArray& k);
         void setMessage(const coder::ByteArray& m);
+        void update(const coder::ByteArray& bytes);
+        void update(const coder::ByteArray& bytes, uint32_t offset, uint32_t length);
+        void update(const uint8_t *bytes, uint64_t length);
+
+    private:
+        void innerHash();
+        void keyStates();
+        void start();
+        // Set the key without the length check, for KDF salts and
+        // passwords.
+        void useKey(const coder::ByteArray& k);
 
     private:
         Digest *hash;
+        Digest *inner;          // State after K XOR ipad
+        Digest *outer;          // State after K XOR opad
         coder::ByteArray K;
         coder::ByteArray ipad;
         coder::ByteArray opad;
         unsigned B;
         unsigned L;
         coder::ByteArray text;
+        uint8_t *h1;            // Inner hash, L bytes
+        bool streaming;         // Inner digest holds part of a message.
 
 };
 
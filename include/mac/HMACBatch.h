@@ -0,0 +1,64 @@
+#ifndef HMACBATCH_H_INCLUDED
+#define HMACBATCH_H_INCLUDED
+
+#include "digest/SHA256Batch.h"
+#include "coder/ByteArray.h"
+#include <deque>
+#include <vector>
+#include <cstdint>
+
+namespace CK {
+
+/*
+ * Multi-buffer HMAC-SHA256.
+ *
+ * Computes or verifies the HMACs of many messages at once with the
+ * multi-buffer SHA-256 lanes. Keys are added once. The hash states
+ * after the inner and outer padded key blocks are kept, so each MAC
+ * costs only the message blocks and one outer block.
+ */
+class HMACBatch {
+
+    public:
+        HMACBatch();
+        ~HMACBatch();
+
+    private:
+        HMACBatch(const HMACBatch& other);
+        HMACBatch& operator= (const HMACBatch& other);
+
+    public:
+        typedef std::deque<unsigned> KeyIds;
+        typedef std::deque<coder::ByteArray> Messages;
+        typedef std::deque<coder::ByteArray> MACs;
+        typedef std::deque<bool> Results;
+
+    public:
+        // Add a key and return its ID.
+        unsigned addKey(const coder::ByteArray& key);
+        // Returns one flag per message, true if the MAC matches. The
+        // comparisons take the same time whether or not they match.
+        Results authenticate(const KeyIds& keys, const Messages& messages,
+                                                        const MACs& macs);
+        // Returns one MAC per message. Message i uses key keys[i].
+        MACs getHMAC(const KeyIds& keys, const Messages& messages);
+        unsigned getLanes() const { return batch.getLanes(); }
+
+    private:
+        struct KeyState {
+            uint32_t inner[8];      // State after K XOR ipad
+            uint32_t outer[8];      // State after K XOR opad
+        };
+
+    private:
+        void mac(const KeyIds& keys, const Messages& messages, uint8_t *out);
+
+    private:
+        SHA256Batch batch;
+        std::vector<KeyState> keyStates;
+
+};
+
+}
+
+#endif  // HMACBATCH_H_INCLUDED
@@ -0,0 +1,60 @@
+#ifndef PBKDF2_H_INCLUDED
+#define PBKDF2_H_INCLUDED
+
+#include <coder/ByteArray.h>
+#include <cstdint>
+
+namespace CK {
+
+class Digest;
+class HMAC;
+
+/*
+ * Password-based key derivation function 2 with HMAC.
+ * See RFC 8018.
+ *
+ * Each block of output is the XOR of a chain of HMACs and doesn't
+ * depend on the other blocks, so blocks are derived on separate
+ * threads. Every thread keys its own HMAC once and then iterates on
+ * fixed buffers from the saved key states. Nothing is allocated in
+ * the iteration loop.
+ */
+class PBKDF2 {
+
+    private:
+        PBKDF2();
+
+    public:
+        // Maximum threads, 0 for one per hardware thread.
+        PBKDF2(Digest *digest, unsigned threads = 0);
+        ~PBKDF2();
+
+    private:
+        PBKDF2(const PBKDF2& other);
+        PBKDF2& operator= (const PBKDF2& other);
+
+    public:
+        coder::ByteArray deriveKey(const coder::ByteArray& password,
+                                        const coder::ByteArray& salt,
+                                        unsigned iterations, unsigned length);
+        // Derive into a caller buffer of length bytes.
+        void deriveKey(const coder::ByteArray& password, const coder::ByteArray& salt,
+                                        unsigned iterations, uint8_t *out, unsigned length);
+
+    private:
+        void block(HMAC& hmac, const coder::ByteArray& salt, unsigned iterations,
+                                        uint32_t index, uint8_t *T, uint8_t *U) const;
+        void blocks(const coder::ByteArray *password, const coder::ByteArray *salt,
+                                        unsigned iterations, unsigned first, unsigned step,
+                                        uint8_t *out, unsigned length) const;
+
+    private:
+        Digest *digest;
+        unsigned threads;
+        unsigned L;
+
+};
+
+}
+
+#endif  // PBKDF2_H_INCLUDED
@@ -1,6 +1,8 @@
 #include "keys/RSAPrivateCrtKey.h"
 #include "exceptions/BadParameterException.h"
 #include "exceptions/DecryptionException.h"
+#include <exception>
+#include <thread>
 
 namespace CK {
 
@@ -8,7 +10,10 @@ RSAPrivateCrtKey::RSAPrivateCrtKey(const BigInteger& p, const BigInteger& q,
                                     const BigInteger& d, const BigInteger& e)
 : RSAPrivateKey(crt),
   p(p),
-  q(q) {
+  q(q),
+  pContext(p),
+  qContext(q),
+  parallel(false) {
 
     BigInteger pp(p - BigInteger::ONE);
     BigInteger qq(q - BigInteger::ONE);
@@ -28,7 +33,10 @@ RSAPrivateCrtKey::RSAPrivateCrtKey(const BigInteger& p, const BigInteger& q,
   q(q),
   dP(dp),
   dQ(dq),
-  qInv(qi) {
+  qInv(qi),
+  pContext(p),
+  qContext(q),
+  parallel(false) {
 
     n = p * q;
     bitLength = n.bitLength();
@@ -36,7 +44,10 @@ RSAPrivateCrtKey::RSAPrivateCrtKey(const BigInteger& p, const BigInteger& q,
 }
 
 RSAPrivateCrtKey::RSAPrivateCrtKey(const RSAPrivateCrtKey& other)
-: RSAPrivateKey(crt) {
+: RSAPrivateKey(crt),
+  pContext(other.pContext),
+  qContext(other.qContext),
+  parallel(other.parallel) {
 
     p = other.p;
     q = other.q;
@@ -58,6 +69,9 @@ RSAPrivateCrtKey& RSAPrivateCrtKey::operator =(const RSAPrivateCrtKey& other) {
     qInv = other.qInv;
     n = other.n;
     d = other.d;
+    pContext = other.pContext;
+    qContext = other.qContext;
+    parallel = other.parallel;
     bitLength = other.bitLength;
     keyType = crt;
     algorithm = "RSA";
@@ -68,6 +82,54 @@ RSAPrivateCrtKey& RSAPrivateCrtKey::operator =(const RSAPrivateCrtKey& other) {
 RSAPrivateCrtKey::~RSAPrivateCrtKey() {
 }
 
+void RSAPrivateCrtKey::exponentiate(const BigInteger& x, BigInteger& x_1,
+                                                        BigInteger& x_2) const {
+
+    Representatives x_1s;
+    Representatives x_2s;
+    exponentiate(Representatives(1, x), x_1s, x_2s);
+    x_1 = x_1s.front();
+    x_2 = x_2s.front();
+
+}
+
+/*
+ * The two exponentiations are independent and each is about an eighth
+ * of the work of one modulo n. In parallel mode the mod p half runs on
+ * a thread of its own while the calling thread does the mod q half.
+ */
+void RSAPrivateCrtKey::exponentiate(const Representatives& x, Representatives& x_1,
+                                                        Representatives& x_2) const {
+
+    if (!parallel) {
+        x_1 = pContext.modPow(x, dP);
+        x_2 = qContext.modPow(x, dQ);
+        return;
+    }
+
+    std::exception_ptr error;
+    std::thread half([this, &x, &x_1, &error] {
+        try {
+            x_1 = pContext.modPow(x, dP);
+        }
+        catch (...) {
+            error = std::current_exception();
+        }
+    });
+    try {
+        x_2 = qContext.modPow(x, dQ);
+    }
+    catch (...) {
+        half.join();
+        throw;
+    }
+    half.join();
+    if (error) {
+        std::rethrow_exception(error);
+    }
+
+}
+
 const BigInteger& RSAPrivateCrtKey::getInverse() const {
 
     return qInv;
@@ -110,8 +172,9 @@ BigInteger RSAPrivateCrtKey::rsadp(const BigInteger& c) const {
     }
 
     // i.    Let m_1 = c^dP mod p and m_2 = c^dQ mod q.
-    BigInteger m_1 = c.modPow(dP, p);
-    BigInteger m_2 = c.modPow(dQ, q);
+    BigInteger m_1;
+    BigInteger m_2;
+    exponentiate(c, m_1, m_2);
 
     // iii.  Let h = (m_1 - m_2) * qInv mod p.
     BigInteger h = (m_1 - m_2) * qInv % p;
@@ -121,6 +184,31 @@ BigInteger RSAPrivateCrtKey::rsadp(const BigInteger& c) const {
 
 }
 
+/*
+ * Batch RSA decryption primitive, CRT method. Every representative is
+ * checked before any is decrypted.
+ */
+RSAPrivateKey::Representatives RSAPrivateCrtKey::rsadp(const Representatives& c) const {
+
+    for (unsigned i = 0; i < c.size(); ++i) {
+        if (c[i] < BigInteger::ZERO || c[i] >= n) {
+            throw DecryptionException();
+        }
+    }
+
+    Representatives m_1;
+    Representatives m_2;
+    exponentiate(c, m_1, m_2);
+
+    Representatives m;
+    for (unsigned i = 0; i < c.size(); ++i) {
+        BigInteger h((m_1[i] - m_2[i]) * qInv % p);
+        m.push_back(m_2[i] + q * h);
+    }
+    return m;
+
+}
+
 /*
  * RSA signature primitive, CRT method.
  */
@@ -137,8 +225,9 @@ BigInteger RSAPrivateCrtKey::rsasp1(const BigInteger& m) const {
 
     //std::cout << "rsasp1 (CRT) m = " << m << std::endl;
     // i.    Let s_1 = m^dP mod p and s_2 = m^dQ mod q.
-    BigInteger s_1(m.modPow(dP, p));
-    BigInteger s_2(m.modPow(dQ, q));
+    BigInteger s_1;
+    BigInteger s_2;
+    exponentiate(m, s_1, s_2);
 
     // iii.  Let h = (s_1 - s_2) * qInv mod p.
     BigInteger h(((s_1 - s_2) * qInv) % p);
@@ -150,5 +239,30 @@ BigInteger RSAPrivateCrtKey::rsasp1(const BigInteger& m) const {
 
 }
 
+/*
+ * Batch RSA signature primitive, CRT method. Every representative is
+ * checked before any is signed.
+ */
+RSAPrivateKey::Representatives RSAPrivateCrtKey::rsasp1(const Representatives& m) const {
+
+    for (unsigned i = 0; i < m.size(); ++i) {
+        if (m[i] < BigInteger::ZERO || m[i] >= n) {
+            throw BadParameterException("Message representative out of range");
+        }
+    }
+
+    Representatives s_1;
+    Representatives s_2;
+    exponentiate(m, s_1, s_2);
+
+    Representatives s;
+    for (unsigned i = 0; i < m.size(); ++i) {
+        BigInteger h(((s_1[i] - s_2[i]) * qInv) % p);
+        s.push_back((q * h) + s_2[i]);
+    }
+    return s;
+
+}
+
 }
 
@@ -7,7 +7,8 @@ RSAPrivateModKey::RSAPrivateModKey(const BigInteger& d,
                 const BigInteger& n)
 : RSAPrivateKey(KeyType::mod),
   prvExp(d),
-  mod(n) {
+  mod(n),
+  modContext(n) {
 
     bitLength = mod.bitLength();
 
@@ -27,7 +28,22 @@ BigInteger RSAPrivateModKey::rsadp(const BigInteger& c) const {
         throw BadParameterException("Message representative out of range");
     }
 
-    return c.modPow(prvExp, mod);
+    return modContext.modPow(c, prvExp);
+
+}
+
+/*
+ * Batch modulus method RSA decryption primitive.
+ */
+RSAPrivateKey::Representatives RSAPrivateModKey::rsadp(const Representatives& c) const {
+
+    for (unsigned i = 0; i < c.size(); ++i) {
+        if (c[i] < BigInteger::ZERO || c[i] >= mod) {
+            throw BadParameterException("Message representative out of range");
+        }
+    }
+
+    return modContext.modPow(c, prvExp);
 
 }
 
@@ -43,7 +59,22 @@ BigInteger RSAPrivateModKey::rsasp1(const BigInteger& m) const {
     }
 
     // Let s = m^d mod n.
-    return BigInteger(m.modPow(prvExp, mod));
+    return modContext.modPow(m, prvExp);
+
+}
+
+/*
+ * Batch modulus method RSA signature primitive.
+ */
+RSAPrivateKey::Representatives RSAPrivateModKey::rsasp1(const Representatives& m) const {
+
+    for (unsigned i = 0; i < m.size(); ++i) {
+        if (m[i] < BigInteger::ZERO || m[i] >= mod) {
+            throw BadParameterException("Message representative out of range");
+        }
+    }
+
+    return modContext.modPow(m, prvExp);
 
 }
 
@@ -5,14 +5,16 @@ namespace CK {
 RSAPublicKey::RSAPublicKey(const BigInteger& n, const BigInteger& e)
 : PublicKey("RSA"),
   exp(e),
-  mod(n) {
+  mod(n),
+  modContext(n) {
 
       bitLength = mod.bitLength();
 
 }
 
 RSAPublicKey::RSAPublicKey(const RSAPublicKey& other)
-: PublicKey("RSA") {    
+: PublicKey("RSA"),
+  modContext(other.modContext) {
 
     bitLength = other.bitLength;
     exp = other.exp;
@@ -26,6 +28,7 @@ RSAPublicKey& RSAPublicKey::operator =(const RSAPublicKey& other) {
     bitLength = other.bitLength;
     exp = other.exp;
     mod = other.mod;
+    modContext = other.modContext;
     return *this;
 
 }
@@ -0,0 +1,99 @@
+#include "mac/HKDF.h"
+#include "digest/Digest.h"
+#include "exceptions/BadParameterException.h"
+#include <memory>
+
+namespace CK {
+
+HKDF::HKDF(Digest *digest)
+: hmac(digest) {
+
+    L = hmac.getDigestLength();
+
+}
+
+HKDF::~HKDF() {
+}
+
+/*
+ * OKM = HKDF-Expand(HKDF-Extract(salt, IKM), info, L)
+ */
+coder::ByteArray HKDF::deriveKey(const coder::ByteArray& salt,
+                                    const coder::ByteArray& ikm,
+                                    const coder::ByteArray& info, unsigned length) {
+
+    return expand(extract(salt, ikm), info, length);
+
+}
+
+/*
+ * Expand a pseudorandom key into length bytes.
+ */
+coder::ByteArray HKDF::expand(const coder::ByteArray& prk,
+                                    const coder::ByteArray& info, unsigned length) {
+
+    std::unique_ptr<uint8_t[]> okm(new uint8_t[length]);
+    expand(prk, info, okm.get(), length);
+    return coder::ByteArray(okm.get(), length);
+
+}
+
+/*
+ * T(0) = empty string
+ * T(i) = HMAC(PRK, T(i - 1) | info | i)
+ * OKM = first length bytes of T(1) | T(2) | ...
+ *
+ * Whole blocks are written straight to the output and chained from
+ * there. Only a short last block goes through a temporary.
+ */
+void HKDF::expand(const coder::ByteArray& prk, const coder::ByteArray& info,
+                                    uint8_t *out, unsigned length) {
+
+    if (length > 255 * L) {
+        throw BadParameterException("HKDF output too long");
+    }
+
+    hmac.setKey(prk);
+    const uint8_t *previous = 0;
+    uint8_t counter = 1;
+    for (unsigned offset = 0; offset < length; offset += L) {
+        if (previous != 0) {
+            hmac.update(previous, L);
+        }
+        hmac.update(info);
+        hmac.update(&counter, 1);
+        counter++;
+        if (length - offset >= L) {
+            hmac.final(out + offset);
+            previous = out + offset;
+        }
+        else {
+            coder::ByteArray T(hmac.final());
+            for (unsigned i = 0; i < length - offset; ++i) {
+                out[offset + i] = T[i];
+            }
+        }
+    }
+
+}
+
+/*
+ * PRK = HMAC(salt, IKM)
+ *
+ * The salt is not secret and may be any length.
+ */
+coder::ByteArray HKDF::extract(const coder::ByteArray& salt,
+                                    const coder::ByteArray& ikm) {
+
+    if (salt.getLength() == 0) {
+        hmac.useKey(coder::ByteArray(L, 0));
+    }
+    else {
+        hmac.useKey(salt);
+    }
+    hmac.update(ikm);
+    return hmac.final();
+
+}
+
+}
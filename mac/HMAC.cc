@@ -3,28 +3,48 @@
 #include "exceptions/BadParameterException.h"
 #include "random/FortunaSecureRandom.h"
 #include "digest/Digest.h"
+#include "data/ConstantTime.h"
 
 namespace CK {
 
 HMAC::HMAC(Digest *digest)
-: hash(digest) {
+: hash(digest),
+  inner(0),
+  outer(0),
+  streaming(false) {
 
     B = hash->getBlockSize();
     L = hash->getDigestLength();
     ipad = coder::ByteArray(B, 0x36);
     opad = coder::ByteArray(B, 0x5C);
+    h1 = new uint8_t[L];
 
 }
 
 HMAC::~HMAC() {
 
+    delete[] h1;
+    delete outer;
+    delete inner;
     delete hash;
 
 }
 
+/*
+ * Check the HMAC of the message set with setMessage. The comparison
+ * takes the same time wherever the values differ.
+ */
 bool HMAC::authenticate(const coder::ByteArray& hmac) {
 
-    return getHMAC() == hmac;
+    if (hmac.getLength() != L) {
+        return false;
+    }
+
+    streaming = false;
+    update(text);
+    // The inner hash buffer is free again once it's been hashed.
+    final(h1);
+    return ConstantTime::equals(h1, hmac, 0, L);
 
 }
 
@@ -41,10 +61,35 @@ coder::ByteArray HMAC::generateKey(unsigned bitsize) {
     FortunaSecureRandom secure;
     K.setLength(bitsize / 8);
     secure.nextBytes(K);
+    keyStates();
     return K;
 
 }
 
+/*
+ * Complete the HMAC of the streamed message.
+ *
+ * H(K XOR opad, H(K XOR ipad, text))
+ *
+ */
+coder::ByteArray HMAC::final() {
+
+    innerHash();
+    return hash->digest();
+
+}
+
+/*
+ * Complete the HMAC of the streamed message into a caller buffer.
+ * Nothing is allocated.
+ */
+void HMAC::final(uint8_t *out) {
+
+    innerHash();
+    hash->digest(out);
+
+}
+
 unsigned HMAC::getDigestLength() const {
 
     return hash->getDigestLength();
@@ -52,16 +97,34 @@ unsigned HMAC::getDigestLength() const {
 }
 
 /*
- * Generate the HMAC.
- *
- * H(K XOR opad, H(K XOR ipad, text))
- *
+ * Generate the HMAC of the message set with setMessage. Any streamed
+ * input is discarded.
  */
 coder::ByteArray HMAC::getHMAC() {
 
-    if (K.getLength() == 0) {
-        throw IllegalStateException("HMAC key not set");
-    }
+    streaming = false;
+    update(text);
+    return final();
+
+}
+
+/*
+ * Finish the inner hash and feed it to the outer key state.
+ */
+void HMAC::innerHash() {
+
+    start();
+    streaming = false;
+    hash->digest(h1);
+    hash->restoreState(*outer);
+    hash->update(h1, L);
+
+}
+
+/*
+ * Hash the inner and outer padded keys and save the digest states.
+ */
+void HMAC::keyStates() {
 
     // Pad or truncate the key until it is B bytes.
     coder::ByteArray k;
@@ -73,16 +136,20 @@ coder::ByteArray HMAC::getHMAC() {
     }
     coder::ByteArray pad(B - k.getLength());
     k.append(pad);
-    hash->reset();
 
-    // First mask.
-    coder::ByteArray i(k ^ ipad);
-    i.append(text);
-    coder::ByteArray h1(hash->digest(i));
     hash->reset();
-    coder::ByteArray o(k ^ opad);
-    o.append(h1);
-    return hash->digest(o);
+    hash->update(k ^ ipad);
+    Digest *i = hash->clone();
+    hash->reset();
+    hash->update(k ^ opad);
+    Digest *o = hash->clone();
+    hash->reset();
+
+    delete inner;
+    delete outer;
+    inner = i;
+    outer = o;
+    streaming = false;
 
 }
 
@@ -92,7 +159,7 @@ void HMAC::setKey(const coder::ByteArray& k) {
         throw BadParameterException("Invalid HMAC key");
     }
 
-    K = k;
+    useKey(k);
 
 }
 
@@ -102,5 +169,66 @@ void HMAC::setMessage(const coder::ByteArray& m) {
 
 }
 
+/*
+ * Start a message from the inner key state if one isn't in progress.
+ */
+void HMAC::start() {
+
+    if (!streaming) {
+        if (K.getLength() == 0) {
+            throw IllegalStateException("HMAC key not set");
+        }
+        hash->restoreState(*inner);
+        streaming = true;
+    }
+
+}
+
+/*
+ * Add bytes to the message.
+ */
+void HMAC::update(const coder::ByteArray& bytes) {
+
+    start();
+    hash->update(bytes);
+
 }
 
+/*
+ * Add a subrange of a byte array to the message.
+ */
+void HMAC::update(const coder::ByteArray& bytes, uint32_t offset, uint32_t length) {
+
+    start();
+    hash->update(bytes, offset, length);
+
+}
+
+/*
+ * Add a memory range to the message.
+ */
+void HMAC::update(const uint8_t *bytes, uint64_t length) {
+
+    start();
+    hash->update(bytes, length);
+
+}
+
+/*
+ * Set the key and hash the padded key blocks. Modes that set the key
+ * for every message keep their states. The keys are compared in fixed
+ * time. Either way, any message in progress is dropped.
+ */
+void HMAC::useKey(const coder::ByteArray& k) {
+
+    if (inner == 0 || !ConstantTime::equals(k, K)) {
+        K = k;
+        keyStates();
+    }
+    else {
+        streaming = false;
+    }
+
+}
+
+}
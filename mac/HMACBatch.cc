@@ -0,0 +1,161 @@
+#include "mac/HMACBatch.h"
+#include "digest/SHA256.h"
+#include "data/ConstantTime.h"
+#include "exceptions/BadParameterException.h"
+#include <string.h>
+
+namespace CK {
+
+HMACBatch::HMACBatch() {
+}
+
+HMACBatch::~HMACBatch() {
+
+    // Don't leave key material behind.
+    if (!keyStates.empty()) {
+        memset(&keyStates[0], 0, keyStates.size() * sizeof(KeyState));
+    }
+
+}
+
+/*
+ * Hash the inner and outer padded key blocks and save the SHA-256
+ * states. Keys longer than the block size are hashed first, as in
+ * RFC 2104.
+ */
+unsigned HMACBatch::addKey(const coder::ByteArray& key) {
+
+    if (key.getLength() < 32) {
+        throw BadParameterException("Invalid HMAC key");
+    }
+
+    SHA256 sha;
+    coder::ByteArray k(key.getLength() > 64 ? sha.digest(key) : key);
+    uint8_t ipad[64];
+    uint8_t opad[64];
+    for (unsigned i = 0; i < 64; ++i) {
+        uint8_t b = i < k.getLength() ? k[i] : 0;
+        ipad[i] = b ^ 0x36;
+        opad[i] = b ^ 0x5c;
+    }
+
+    KeyState state;
+    sha.reset();
+    sha.compress(ipad);
+    memcpy(state.inner, sha.H, sizeof(state.inner));
+    sha.reset();
+    sha.compress(opad);
+    memcpy(state.outer, sha.H, sizeof(state.outer));
+    sha.reset();
+    memset(ipad, 0, sizeof(ipad));
+    memset(opad, 0, sizeof(opad));
+
+    keyStates.push_back(state);
+    return keyStates.size() - 1;
+
+}
+
+/*
+ * Verify the MAC of each message. Every byte of every MAC is
+ * compared, so the time taken doesn't show where a MAC differs.
+ */
+HMACBatch::Results HMACBatch::authenticate(const KeyIds& keys,
+                                const Messages& messages, const MACs& macs) {
+
+    unsigned count = messages.size();
+    if (macs.size() != count) {
+        throw BadParameterException("HMAC batch counts differ");
+    }
+
+    uint8_t *out = new uint8_t[count * 32];
+    try {
+        mac(keys, messages, out);
+    }
+    catch (...) {
+        delete[] out;
+        throw;
+    }
+
+    Results results;
+    for (unsigned i = 0; i < count; ++i) {
+        results.push_back(macs[i].getLength() == 32
+                            && ConstantTime::equals(out + (i * 32), macs[i], 0, 32));
+    }
+
+    delete[] out;
+    return results;
+
+}
+
+/*
+ * Compute the MAC of each message.
+ */
+HMACBatch::MACs HMACBatch::getHMAC(const KeyIds& keys, const Messages& messages) {
+
+    unsigned count = messages.size();
+    uint8_t *out = new uint8_t[count * 32];
+    try {
+        mac(keys, messages, out);
+    }
+    catch (...) {
+        delete[] out;
+        throw;
+    }
+
+    MACs macs;
+    for (unsigned i = 0; i < count; ++i) {
+        macs.push_back(coder::ByteArray(out + (i * 32), 32));
+    }
+
+    delete[] out;
+    return macs;
+
+}
+
+/*
+ * H(K XOR opad, H(K XOR ipad, text))
+ *
+ * The inner hashes of all messages are run through the lanes first,
+ * starting from the saved inner key states. The outer hashes are
+ * then run over the inner hash values from the outer key states.
+ * Both passes skip the 64 byte key block, which is already in the
+ * states.
+ */
+void HMACBatch::mac(const KeyIds& keys, const Messages& messages, uint8_t *out) {
+
+    unsigned count = messages.size();
+    if (keys.size() != count) {
+        throw BadParameterException("HMAC batch counts differ");
+    }
+    for (unsigned i = 0; i < count; ++i) {
+        if (keys[i] >= keyStates.size()) {
+            throw BadParameterException("Invalid HMAC key ID");
+        }
+    }
+
+    SHA256Batch::Job *jobs = new SHA256Batch::Job[count];
+    uint8_t *buffer = SHA256Batch::loadMessages(messages, jobs);
+    uint8_t *inner = new uint8_t[count * 32];
+    for (unsigned i = 0; i < count; ++i) {
+        jobs[i].iv = keyStates[keys[i]].inner;
+        jobs[i].prefix = 64;
+        jobs[i].out = inner + (i * 32);
+    }
+    batch.run(jobs, count);
+
+    // The inner hashes are the outer messages.
+    for (unsigned i = 0; i < count; ++i) {
+        jobs[i].message = inner + (i * 32);
+        jobs[i].length = 32;
+        jobs[i].iv = keyStates[keys[i]].outer;
+        jobs[i].out = out + (i * 32);
+    }
+    batch.run(jobs, count);
+
+    delete[] inner;
+    delete[] buffer;
+    delete[] jobs;
+
+}
+
+}
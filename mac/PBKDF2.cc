@@ -0,0 +1,157 @@
+#include "mac/PBKDF2.h"
+#include "mac/HMAC.h"
+#include "digest/Digest.h"
+#include "exceptions/BadParameterException.h"
+#include <algorithm>
+#include <exception>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <string.h>
+
+namespace CK {
+
+PBKDF2::PBKDF2(Digest *d, unsigned t)
+: digest(d),
+  threads(t) {
+
+    L = digest->getDigestLength();
+    if (threads == 0) {
+        threads = std::max(1U, std::thread::hardware_concurrency());
+    }
+
+}
+
+PBKDF2::~PBKDF2() {
+
+    delete digest;
+
+}
+
+/*
+ * F(P, S, c, i) = U1 XOR U2 XOR ... XOR Uc
+ *
+ * U1 = PRF(P, S || INT(i))
+ * Uj = PRF(P, Uj-1)
+ */
+void PBKDF2::block(HMAC& hmac, const coder::ByteArray& salt, unsigned iterations,
+                                    uint32_t index, uint8_t *T, uint8_t *U) const {
+
+    uint8_t i[4];
+    i[0] = index >> 24;
+    i[1] = index >> 16;
+    i[2] = index >> 8;
+    i[3] = index;
+    hmac.update(salt);
+    hmac.update(i, 4);
+    hmac.final(U);
+    memcpy(T, U, L);
+
+    for (unsigned c = 1; c < iterations; ++c) {
+        hmac.update(U, L);
+        hmac.final(U);
+        for (unsigned j = 0; j < L; ++j) {
+            T[j] ^= U[j];
+        }
+    }
+
+}
+
+/*
+ * Derive every step'th block starting with block first, counting
+ * from 0. Whole blocks are derived in place. A short last block goes
+ * through the scratch buffer.
+ */
+void PBKDF2::blocks(const coder::ByteArray *password, const coder::ByteArray *salt,
+                                    unsigned iterations, unsigned first, unsigned step,
+                                    uint8_t *out, unsigned length) const {
+
+    HMAC hmac(digest->clone());
+    // An empty key pads to the same block as a single zero byte.
+    hmac.useKey(password->getLength() == 0 ? coder::ByteArray(1, 0) : *password);
+
+    std::unique_ptr<uint8_t[]> U(new uint8_t[L]);
+    std::unique_ptr<uint8_t[]> T(new uint8_t[L]);
+    for (unsigned b = first; b * L < length; b += step) {
+        unsigned offset = b * L;
+        if (length - offset >= L) {
+            block(hmac, *salt, iterations, b + 1, out + offset, U.get());
+        }
+        else {
+            block(hmac, *salt, iterations, b + 1, T.get(), U.get());
+            memcpy(out + offset, T.get(), length - offset);
+        }
+    }
+    memset(U.get(), 0, L);
+    memset(T.get(), 0, L);
+
+}
+
+/*
+ * DK = T1 || T2 || ... truncated to length bytes.
+ */
+coder::ByteArray PBKDF2::deriveKey(const coder::ByteArray& password,
+                                    const coder::ByteArray& salt,
+                                    unsigned iterations, unsigned length) {
+
+    std::unique_ptr<uint8_t[]> dk(new uint8_t[length]);
+    deriveKey(password, salt, iterations, dk.get(), length);
+    coder::ByteArray key(dk.get(), length);
+    memset(dk.get(), 0, length);
+    return key;
+
+}
+
+/*
+ * The blocks are dealt out to the threads round robin. The calling
+ * thread takes the last share.
+ */
+void PBKDF2::deriveKey(const coder::ByteArray& password, const coder::ByteArray& salt,
+                                    unsigned iterations, uint8_t *out, unsigned length) {
+
+    if (iterations == 0) {
+        throw BadParameterException("Invalid PBKDF2 iteration count");
+    }
+    if (length == 0) {
+        return;
+    }
+
+    unsigned count = (length + L - 1) / L;
+    unsigned workers = std::min(threads, count);
+    // Threads that have started are always joined, and an exception on
+    // any thread is passed to the caller once they have been.
+    std::vector<std::exception_ptr> errors(workers - 1);
+    std::vector<std::thread> pool;
+    pool.reserve(workers - 1);
+    try {
+        for (unsigned w = 0; w < workers - 1; ++w) {
+            pool.push_back(std::thread([this, &password, &salt, iterations, w,
+                                                workers, out, length, &errors] {
+                try {
+                    blocks(&password, &salt, iterations, w, workers, out, length);
+                }
+                catch (...) {
+                    errors[w] = std::current_exception();
+                }
+            }));
+        }
+        blocks(&password, &salt, iterations, workers - 1, workers, out, length);
+    }
+    catch (...) {
+        for (unsigned i = 0; i < pool.size(); ++i) {
+            pool[i].join();
+        }
+        throw;
+    }
+    for (unsigned i = 0; i < pool.size(); ++i) {
+        pool[i].join();
+    }
+    for (unsigned i = 0; i < errors.size(); ++i) {
+        if (errors[i]) {
+            std::rethrow_exception(errors[i]);
+        }
+    }
+
+}
+
+}
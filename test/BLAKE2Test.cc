@@ -0,0 +1,89 @@
+#include "digest/BLAKE2b.h"
+#include "digest/BLAKE2s.h"
+#include "TestVectors.h"
+#include <iostream>
+
+using namespace CK;
+
+/*
+ * RFC 7693 known answers for BLAKE2b and BLAKE2s: the "abc" examples
+ * of appendices A and B, and the unkeyed half of the appendix E self
+ * test, which hashes the RFC's test sequences at several digest and
+ * message lengths into a grand hash. Keyed hashing isn't supported,
+ * so the grand hashes were computed with Python's hashlib without the
+ * keyed results. The length sweeps cover every padding case.
+ */
+
+static const char *BLAKE2B_ABC =
+    "ba80a53f981c4d0d6a2797b69f12f6e94c212f14685ac4b74b12bb6fdbffa2d1"
+    "7d87c5392aab792dc252d5de4533cc9518d38aa8dbf1925ab92386edd4009923";
+static const char *BLAKE2B_GRAND =
+    "681f345ad53c6360214ea500fd259edddbca775f605fad81b9b189d6d88e15c6";
+static const char *BLAKE2B_SWEEP =
+    "747d990a43aad3f30d194170c88be35d775cb996379094fc8ad2bff91875d847"
+    "d15311df755c407b9c4559d6bab5aca58ae86b1269fcdff5ce19a59abc9e0f35";
+
+static const char *BLAKE2S_ABC =
+    "508c5e8c327c14e2e1a72ba34eeb452f37458b209ed63a294d999b4c86675982";
+static const char *BLAKE2S_GRAND =
+    "f3beed67aa7807e27881fd59dd3184a82264d10ca8528b92fc5198dd8811e660";
+static const char *BLAKE2S_SWEEP =
+    "b0d0f094f094dbd0c0bd6e23b4c4691215c8b045f583751a910a0fe8feaefcbd";
+
+// The RFC 7693 self test sequence, a Fibonacci generator.
+static coder::ByteArray selfTestSequence(unsigned length, uint32_t seed) {
+
+    uint32_t a = 0xdead4bad * seed;
+    uint32_t b = 1;
+    coder::ByteArray sequence;
+    for (unsigned i = 0; i < length; ++i) {
+        uint32_t t = a + b;
+        a = b;
+        b = t;
+        sequence.append(t >> 24);
+    }
+    return sequence;
+
+}
+
+template<class D>
+static coder::ByteArray grandHash(const unsigned *digestLengths,
+                                        const unsigned *messageLengths) {
+
+    D grand(32);
+    for (unsigned d = 0; d < 4; ++d) {
+        D digest(digestLengths[d]);
+        for (unsigned m = 0; m < 6; ++m) {
+            unsigned length = messageLengths[m];
+            grand.update(digest.digest(selfTestSequence(length, length)));
+        }
+    }
+    return grand.digest();
+
+}
+
+int main() {
+
+    int failed = 0;
+    coder::ByteArray abc(fromHex("616263"));
+
+    BLAKE2b blake2b;
+    check(blake2b.digest(abc) == fromHex(BLAKE2B_ABC), "BLAKE2b-512 abc", failed);
+    unsigned bDigestLengths[] = { 20, 32, 48, 64 };
+    unsigned bMessageLengths[] = { 0, 3, 128, 129, 255, 1024 };
+    check(grandHash<BLAKE2b>(bDigestLengths, bMessageLengths) == fromHex(BLAKE2B_GRAND),
+                                    "BLAKE2b self test", failed);
+    check(sweep(blake2b) == fromHex(BLAKE2B_SWEEP), "BLAKE2b-512 sweep", failed);
+
+    BLAKE2s blake2s;
+    check(blake2s.digest(abc) == fromHex(BLAKE2S_ABC), "BLAKE2s-256 abc", failed);
+    unsigned sDigestLengths[] = { 16, 20, 28, 32 };
+    unsigned sMessageLengths[] = { 0, 3, 64, 65, 255, 1024 };
+    check(grandHash<BLAKE2s>(sDigestLengths, sMessageLengths) == fromHex(BLAKE2S_GRAND),
+                                    "BLAKE2s self test", failed);
+    check(sweep(blake2s) == fromHex(BLAKE2S_SWEEP), "BLAKE2s-256 sweep", failed);
+
+    std::cout << (failed == 0 ? "BLAKE2 tests passed" : "BLAKE2 tests failed") << std::endl;
+    return failed == 0 ? 0 : 1;
+
+}
@@ -0,0 +1,108 @@
+#include "digest/BLAKE3.h"
+#include "TestVectors.h"
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+using namespace CK;
+
+/*
+ * Known answers from the official BLAKE3 test vectors. The input is
+ * the byte sequence i mod 251. Each length is hashed through the
+ * ByteArray and memory range overloads and in 1000 byte updates, which
+ * leave the chunk buffer at a different offset for every lane batch.
+ * The vectors give 131 bytes of output. The first 32 are checked at
+ * every length, and all 131 at the shortest and longest.
+ *
+ * A 3 MiB input, above the subtree threshold, is hashed on one and
+ * four threads. Its answer was computed with the reference
+ * implementation's Python binding.
+ */
+
+static const unsigned LENGTHS[] = { 0, 1, 1023, 1024, 1025, 2048, 2049, 3072,
+                                    3073, 4096, 4097, 5120, 5121, 6144, 6145,
+                                    7168, 7169, 8192, 8193, 16384, 31744, 102400 };
+
+static const char *EXPECTED[] = {
+    "af1349b9f5f9a1a6a0404dea36dcc9499bcb25c9adc112b7cc9a93cae41f3262",
+    "2d3adedff11b61f14c886e35afa036736dcd87a74d27b5c1510225d0f592e213",
+    "10108970eeda3eb932baac1428c7a2163b0e924c9a9e25b35bba72b28f70bd11",
+    "42214739f095a406f3fc83deb889744ac00df831c10daa55189b5d121c855af7",
+    "d00278ae47eb27b34faecf67b4fe263f82d5412916c1ffd97c8cb7fb814b8444",
+    "e776b6028c7cd22a4d0ba182a8bf62205d2ef576467e838ed6f2529b85fba24a",
+    "5f4d72f40d7a5f82b15ca2b2e44b1de3c2ef86c426c95c1af0b6879522563030",
+    "b98cb0ff3623be03326b373de6b9095218513e64f1ee2edd2525c7ad1e5cffd2",
+    "7124b49501012f81cc7f11ca069ec9226cecb8a2c850cfe644e327d22d3e1cd3",
+    "015094013f57a5277b59d8475c0501042c0b642e531b0a1c8f58d2163229e969",
+    "9b4052b38f1c5fc8b1f9ff7ac7b27cd242487b3d890d15c96a1c25b8aa0fb995",
+    "9cadc15fed8b5d854562b26a9536d9707cadeda9b143978f319ab34230535833",
+    "628bd2cb2004694adaab7bbd778a25df25c47b9d4155a55f8fbd79f2fe154cff",
+    "3e2e5b74e048f3add6d21faab3f83aa44d3b2278afb83b80b3c35164ebeca205",
+    "f1323a8631446cc50536a9f705ee5cb619424d46887f3c376c695b70e0f0507f",
+    "61da957ec2499a95d6b8023e2b0e604ec7f6b50e80a9678b89d2628e99ada77a",
+    "a003fc7a51754a9b3c7fae0367ab3d782dccf28855a03d435f8cfe74605e7817",
+    "aae792484c8efe4f19e2ca7d371d8c467ffb10748d8a5a1ae579948f718a2a63",
+    "bab6c09cb8ce8cf459261398d2e7aef35700bf488116ceb94a36d0f5f1b7bc3b",
+    "f875d6646de28985646f34ee13be9a576fd515f76b5b0a26bb324735041ddde4",
+    "62b6960e1a44bcc1eb1a611a8d6235b6b4b78f32e7abc4fb4c6cdcce94895c47",
+    "bc3e3d41a1146b069abffad3c0d44860cf664390afce4d9661f7902e7943e085"
+};
+
+static const char *EXTENDED_0 =
+    "af1349b9f5f9a1a6a0404dea36dcc9499bcb25c9adc112b7cc9a93cae41f3262"
+    "e00f03e7b69af26b7faaf09fcd333050338ddfe085b8cc869ca98b206c08243a"
+    "26f5487789e8f660afe6c99ef9e0c52b92e7393024a80459cf91f476f9ffdbda"
+    "7001c22e159b402631f277ca96f2defdf1078282314e763699a31c5363165421"
+    "cce14d";
+
+static const char *EXTENDED_102400 =
+    "bc3e3d41a1146b069abffad3c0d44860cf664390afce4d9661f7902e7943e085"
+    "e01c59dab908c04c3342b816941a26d69c2605ebee5ec5291cc55e15b76146e6"
+    "745f0601156c3596cb75065a9c57f35585a52e1ac70f69131c23d611ce11ee4a"
+    "b1ec2c009012d236648e77be9295dd0426f29b764d65de58eb7d01dd42248204"
+    "f45f8e";
+
+static const unsigned LARGE_LENGTH = 3 * 1024 * 1024 + 777;
+static const char *LARGE_EXPECTED =
+    "af47dfe5284779cecdf26b7bb8209b1a4ca1e24bb168adff9f9ee4294a9e52e9";
+
+int main() {
+
+    int failed = 0;
+    std::vector<uint8_t> input(LARGE_LENGTH);
+    for (unsigned i = 0; i < LARGE_LENGTH; ++i) {
+        input[i] = i % 251;
+    }
+
+    BLAKE3 blake3;
+    for (unsigned l = 0; l < 22; ++l) {
+        unsigned length = LENGTHS[l];
+        coder::ByteArray answer(fromHex(EXPECTED[l]));
+        std::string name("BLAKE3 " + std::to_string(length) + " bytes");
+
+        check(blake3.digest(coder::ByteArray(input.data(), length)) == answer, name, failed);
+        check(blake3.digest(input.data(), length) == answer, name + " in place", failed);
+
+        for (unsigned i = 0; i < length; i += 1000) {
+            blake3.update(input.data() + i, std::min(1000U, length - i));
+        }
+        check(blake3.digest() == answer, name + " in pieces", failed);
+    }
+
+    BLAKE3 extended(131);
+    check(extended.digest(input.data(), 0) == fromHex(EXTENDED_0),
+                                    "BLAKE3 0 bytes extended output", failed);
+    check(extended.digest(input.data(), 102400) == fromHex(EXTENDED_102400),
+                                    "BLAKE3 102400 bytes extended output", failed);
+
+    unsigned threads[] = { 1, 4 };
+    for (unsigned t = 0; t < 2; ++t) {
+        blake3.setThreads(threads[t]);
+        check(blake3.digest(input.data(), LARGE_LENGTH) == fromHex(LARGE_EXPECTED),
+                "BLAKE3 large input on " + std::to_string(threads[t]) + " threads", failed);
+    }
+
+    std::cout << (failed == 0 ? "BLAKE3 tests passed" : "BLAKE3 tests failed") << std::endl;
+    return failed == 0 ? 0 : 1;
+
+}
@@ -0,0 +1,59 @@
+#include "ciphermodes/EtM.h"
+#include "ciphermodes/CBC.h"
+#include "cipher/AES.h"
+#include "mac/HMAC.h"
+#include "digest/SHA256.h"
+#include "exceptions/AuthenticationException.h"
+#include <iostream>
+
+using namespace CK;
+
+/*
+ * Encrypt-then-MAC round trips with AES-128 and AES-256 keys, a partial
+ * last block, tampering, and a ciphertext shorter than a tag.
+ */
+int main() {
+
+    int failed = 0;
+    coder::ByteArray iv(16, 0x03);
+    coder::ByteArray plaintext;
+    for (unsigned i = 0; i < 40; ++i) {
+        plaintext.append(i);
+    }
+
+    AES::KeySize sizes[] = { AES::AES128, AES::AES256 };
+    for (unsigned s = 0; s < 2; ++s) {
+        EtM etm(new CBC(new AES(sizes[s])), new HMAC(new SHA256));
+        coder::ByteArray key(sizes[s], 0x07);
+        etm.setIV(iv);
+
+        coder::ByteArray ciphertext(etm.encrypt(plaintext, key));
+        if (ciphertext.getLength() != plaintext.getLength() + 32
+                                    || etm.decrypt(ciphertext, key) != plaintext) {
+            std::cout << "EtM round trip failed, key length "
+                                    << sizes[s] << std::endl;
+            failed++;
+        }
+
+        ciphertext[20] = ciphertext[20] ^ 0x01;
+        try {
+            etm.decrypt(ciphertext, key);
+            std::cout << "EtM accepted a modified ciphertext" << std::endl;
+            failed++;
+        }
+        catch (AuthenticationException& e) {
+        }
+
+        try {
+            etm.decrypt(coder::ByteArray(16, 0x01), key);
+            std::cout << "EtM accepted a ciphertext shorter than a tag" << std::endl;
+            failed++;
+        }
+        catch (AuthenticationException& e) {
+        }
+    }
+
+    std::cout << (failed == 0 ? "EtM tests passed" : "EtM tests failed") << std::endl;
+    return failed == 0 ? 0 : 1;
+
+}
@@ -0,0 +1,135 @@
+#include "mac/HKDF.h"
+#include "digest/SHA1.h"
+#include "digest/SHA256.h"
+#include "TestVectors.h"
+#include <iostream>
+#include <vector>
+
+using namespace CK;
+
+/*
+ * RFC 5869 known answers for HKDF with SHA-256 and SHA-1. Each case
+ * checks the pseudorandom key from extract(), the output of expand()
+ * as a ByteArray and into a buffer, and deriveKey(). Cases 3, 6 and 7
+ * have an empty salt, which extract() replaces with zeros.
+ */
+
+struct TestCase {
+    bool sha1;
+    const char *ikm;
+    const char *salt;
+    const char *info;
+    unsigned length;
+    const char *prk;
+    const char *okm;
+};
+
+static const TestCase CASES[] = {
+    // Test case 1
+    { false,
+      "0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b",
+      "000102030405060708090a0b0c",
+      "f0f1f2f3f4f5f6f7f8f9",
+      42,
+      "077709362c2e32df0ddc3f0dc47bba6390b6c73bb50f9c3122ec844ad7c2b3e5",
+      "3cb25f25faacd57a90434f64d0362f2a2d2d0a90cf1a5a4c5db02d56ecc4c5bf"
+      "34007208d5b887185865" },
+    // Test case 2
+    { false,
+      "000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f"
+      "202122232425262728292a2b2c2d2e2f303132333435363738393a3b3c3d3e3f"
+      "404142434445464748494a4b4c4d4e4f",
+      "606162636465666768696a6b6c6d6e6f707172737475767778797a7b7c7d7e7f"
+      "808182838485868788898a8b8c8d8e8f909192939495969798999a9b9c9d9e9f"
+      "a0a1a2a3a4a5a6a7a8a9aaabacadaeaf",
+      "b0b1b2b3b4b5b6b7b8b9babbbcbdbebfc0c1c2c3c4c5c6c7c8c9cacbcccdcecf"
+      "d0d1d2d3d4d5d6d7d8d9dadbdcdddedfe0e1e2e3e4e5e6e7e8e9eaebecedeeef"
+      "f0f1f2f3f4f5f6f7f8f9fafbfcfdfeff",
+      82,
+      "06a6b88c5853361a06104c9ceb35b45cef760014904671014a193f40c15fc244",
+      "b11e398dc80327a1c8e7f78c596a49344f012eda2d4efad8a050cc4c19afa97c"
+      "59045a99cac7827271cb41c65e590e09da3275600c2f09b8367793a9aca3db71"
+      "cc30c58179ec3e87c14c01d5c1f3434f1d87" },
+    // Test case 3
+    { false,
+      "0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b",
+      "",
+      "",
+      42,
+      "19ef24a32c717b167f33a91d6f648bdf96596776afdb6377ac434c1c293ccb04",
+      "8da4e775a563c18f715f802a063c5a31b8a11f5c5ee1879ec3454e5f3c738d2d"
+      "9d201395faa4b61a96c8" },
+    // Test case 4
+    { true,
+      "0b0b0b0b0b0b0b0b0b0b0b",
+      "000102030405060708090a0b0c",
+      "f0f1f2f3f4f5f6f7f8f9",
+      42,
+      "9b6c18c432a7bf8f0e71c8eb88f4b30baa2ba243",
+      "085a01ea1b10f36933068b56efa5ad81a4f14b822f5b091568a9cdd4f155fda2"
+      "c22e422478d305f3f896" },
+    // Test case 5
+    { true,
+      "000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f"
+      "202122232425262728292a2b2c2d2e2f303132333435363738393a3b3c3d3e3f"
+      "404142434445464748494a4b4c4d4e4f",
+      "606162636465666768696a6b6c6d6e6f707172737475767778797a7b7c7d7e7f"
+      "808182838485868788898a8b8c8d8e8f909192939495969798999a9b9c9d9e9f"
+      "a0a1a2a3a4a5a6a7a8a9aaabacadaeaf",
+      "b0b1b2b3b4b5b6b7b8b9babbbcbdbebfc0c1c2c3c4c5c6c7c8c9cacbcccdcecf"
+      "d0d1d2d3d4d5d6d7d8d9dadbdcdddedfe0e1e2e3e4e5e6e7e8e9eaebecedeeef"
+      "f0f1f2f3f4f5f6f7f8f9fafbfcfdfeff",
+      82,
+      "8adae09a2a307059478d309b26c4115a224cfaf6",
+      "0bd770a74d1160f7c9f12cd5912a06ebff6adcae899d92191fe4305673ba2ffe"
+      "8fa3f1a4e5ad79f3f334b3b202b2173c486ea37ce3d397ed034c7f9dfeb15c5e"
+      "927336d0441f4c4300e2cff0d0900b52d3b4" },
+    // Test case 6
+    { true,
+      "0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b",
+      "",
+      "",
+      42,
+      "da8c8a73c7fa77288ec6f5e7c297786aa0d32d01",
+      "0ac1af7002b3d761d1e55298da9d0506b9ae52057220a306e07b6b87e8df21d0"
+      "ea00033de03984d34918" },
+    // Test case 7
+    { true,
+      "0c0c0c0c0c0c0c0c0c0c0c0c0c0c0c0c0c0c0c0c0c0c",
+      "",
+      "",
+      42,
+      "2adccada18779e7c2077ad2eb19d3f3e731385dd",
+      "2c91117204d745f3500d636a62f64f0ab3bae548aa53d423b0d1f27ebba6f5e5"
+      "673a081d70cce7acfc48" }
+};
+
+int main() {
+
+    int failed = 0;
+
+    for (unsigned c = 0; c < 7; ++c) {
+        const TestCase& tc(CASES[c]);
+        HKDF hkdf(tc.sha1 ? static_cast<Digest*>(new SHA1) : new SHA256);
+        std::string name("HKDF test case " + std::to_string(c + 1));
+        coder::ByteArray ikm(fromHex(tc.ikm));
+        coder::ByteArray salt(fromHex(tc.salt));
+        coder::ByteArray info(fromHex(tc.info));
+        coder::ByteArray okm(fromHex(tc.okm));
+
+        coder::ByteArray prk(hkdf.extract(salt, ikm));
+        check(prk == fromHex(tc.prk), name + " extract", failed);
+        check(hkdf.expand(prk, info, tc.length) == okm, name + " expand", failed);
+
+        std::vector<uint8_t> out(tc.length);
+        hkdf.expand(prk, info, out.data(), tc.length);
+        check(coder::ByteArray(out.data(), tc.length) == okm,
+                                        name + " expand into a buffer", failed);
+
+        check(hkdf.deriveKey(salt, ikm, info, tc.length) == okm, name + " derive", failed);
+    }
+
+    std::cout << (failed == 0 ? "HKDF tests passed" : "HKDF tests failed") << std::endl;
+    return failed == 0 ? 0 : 1;
+
+}
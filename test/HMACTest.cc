@@ -0,0 +1,107 @@
+#include "mac/HMAC.h"
+#include "digest/SHA224.h"
+#include "digest/SHA256.h"
+#include "digest/SHA384.h"
+#include "digest/SHA512.h"
+#include "exceptions/BadParameterException.h"
+#include "TestVectors.h"
+#include <iostream>
+
+using namespace CK;
+
+/*
+ * RFC 4231 known answers for HMAC-SHA-224, 256, 384 and 512. Test
+ * cases 1 to 5 use keys shorter than the digest, which setKey()
+ * refuses, so only cases 6 and 7 apply. Their 131 byte key is hashed
+ * before use, and case 7's message spans more than one block. Each
+ * case is run through setMessage() and getHMAC(), authenticate(), and
+ * streamed a byte at a time, and again after switching to another key
+ * and back, which recomputes the saved key states.
+ */
+
+static const std::string MESSAGES[] = {
+    "Test Using Larger Than Block-Size Key - Hash Key First",
+    "This is a test using a larger than block-size key and a larger "
+    "than block-size data. The key needs to be hashed before being "
+    "used by the HMAC algorithm."
+};
+
+static const char *SHA224_EXPECTED[] = {
+    "95e9a0db962095adaebe9b2d6f0dbce2d499f112f2d2b7273fa6870e",
+    "3a854166ac5d9f023f54d517d0b39dbd946770db9c2b95c9f6f565d1"
+};
+
+static const char *SHA256_EXPECTED[] = {
+    "60e431591ee0b67f0d8a26aacbf5b77f8e0bc6213728c5140546040f0ee37f54",
+    "9b09ffa71b942fcb27635fbcd5b0e944bfdc63644f0713938a7f51535c3a35e2"
+};
+
+static const char *SHA384_EXPECTED[] = {
+    "4ece084485813e9088d2c63a041bc5b44f9ef1012a2b588f"
+    "3cd11f05033ac4c60c2ef6ab4030fe8296248df163f44952",
+    "6617178e941f020d351e2f254e8fd32c602420feb0b8fb9a"
+    "dccebb82461e99c5a678cc31e799176d3860e6110c46523e"
+};
+
+static const char *SHA512_EXPECTED[] = {
+    "80b24263c7c1a3ebb71493c1dd7be8b49b46d1f41b4aeec1121b013783f8f352"
+    "6b56d037e05f2598bd0fd2215d6a1e5295e64f73f63f0aec8b915a985d786598",
+    "e37b6a775dc87dbaa4dfa9f96e5e3ffddebd71f8867289865df5a32d20cdc944"
+    "b6022cac3c4982b10d5eeb55c3e4de15134676fb6de0446065c97440fa8c6a58"
+};
+
+static void testVectors(HMAC& hmac, const std::string& name,
+                                        const char **expected, int& failed) {
+
+    coder::ByteArray key(131, 0xaa);
+    coder::ByteArray otherKey(64, 0x0b);
+    for (unsigned pass = 0; pass < 2; ++pass) {
+        for (unsigned m = 0; m < 2; ++m) {
+            coder::ByteArray message(reinterpret_cast<const uint8_t*>(MESSAGES[m].data()),
+                                                                MESSAGES[m].length());
+            coder::ByteArray answer(fromHex(expected[m]));
+            std::string test(name + " test case " + std::to_string(6 + m)
+                                            + (pass == 0 ? "" : " after a key change"));
+
+            hmac.setKey(key);
+            hmac.setMessage(message);
+            check(hmac.getHMAC() == answer, test, failed);
+            check(hmac.authenticate(answer), test + " authenticate", failed);
+
+            for (unsigned i = 0; i < message.getLength(); ++i) {
+                hmac.update(message, i, 1);
+            }
+            check(hmac.final() == answer, test + " streamed", failed);
+        }
+        hmac.setKey(otherKey);
+        hmac.setMessage(coder::ByteArray(4, 0x00));
+        hmac.getHMAC();
+    }
+
+}
+
+int main() {
+
+    int failed = 0;
+
+    HMAC sha224(new SHA224);
+    testVectors(sha224, "HMAC-SHA-224", SHA224_EXPECTED, failed);
+    HMAC sha256(new SHA256);
+    testVectors(sha256, "HMAC-SHA-256", SHA256_EXPECTED, failed);
+    HMAC sha384(new SHA384);
+    testVectors(sha384, "HMAC-SHA-384", SHA384_EXPECTED, failed);
+    HMAC sha512(new SHA512);
+    testVectors(sha512, "HMAC-SHA-512", SHA512_EXPECTED, failed);
+
+    try {
+        sha256.setKey(fromHex("4a656665"));
+        std::cout << "HMAC accepted a key shorter than the digest" << std::endl;
+        failed++;
+    }
+    catch (BadParameterException& e) {
+    }
+
+    std::cout << (failed == 0 ? "HMAC tests passed" : "HMAC tests failed") << std::endl;
+    return failed == 0 ? 0 : 1;
+
+}
@@ -0,0 +1,162 @@
+#include "data/MontgomeryContext.h"
+#include "data/FixedMontgomery.h"
+#include "data/BigInteger.h"
+#include "TestVectors.h"
+#include <iostream>
+
+using namespace CK;
+
+/*
+ * Known answers for the fixed width Montgomery exponentiation at 16,
+ * 24 and 32 limbs, directly and through MontgomeryContext.
+ *
+ * The modulus is 2^64N - 159. Lying just below R, it makes the final
+ * subtraction of n, and the carry out of the top limb, frequent. The
+ * private exponent has 64N bits, so every 5 bit window is taken from
+ * the table by the masked scan. The answers were computed with
+ * Python's pow().
+ */
+
+// base^e and base^65537 mod n.
+static const char *EXPECTED_16[] = {
+    "554721517bd5a4a3ace26bedb722987d8777d4da5d468274d8c3ba2143866ac0"
+    "f8f972bd483b72f1b8ee6ca1a295784cbd5838ef81eca2559ddc82cc5e0c6464"
+    "a3418cce5d8c29499caf3313d958039ab9d6333f3cf9ce55768840c3881ce353"
+    "ceeb17c4a90293998b1c0b2fd5d4a8b0def7a44af3296bac05642a86a8ec3437",
+    "bfbe56e8a4f6733365128b189998632c08d206a274f5addbf9cd3e338f21325d"
+    "b0c6dd9870a1807c36e62b73c7ecedd722ba3d535d5242434838a47629859e82"
+    "ed0fb10fbd9ffa6b391ecb5f7a92ac382700b18c59e70ef32bd71dfec52533a8"
+    "9865cd419d11054a660ced95142188cde3ff42279c54edb61eda1520e94bc8c3"
+};
+
+static const char *EXPECTED_24[] = {
+    "b5f39bdfadc9936cd0bd5fc6ab8281ecaceac0212af3288702cc6c5beec5fa88"
+    "0ba145140a0bb46533636d65fd5a3829e47ec2669e1ca37c9526f03d96081514"
+    "2bae8dc691626b8f3de21e757247210e8d9df05c9d311cc71f69f9761c4753de"
+    "f93ac2ea59a5bc74a106548b56ac805a61864a5e45c7ec47289c24c014490aaa"
+    "31d8b81db19b72bd8377694ebed30ff9b126a173817ea972ba6a1193e5a39616"
+    "62b5a10cea59887b113a32a98ef80f5b1586fcd80b12947591c82b7a7cd44167",
+    "d7b6b3ebde5ab1f021df7daa71eda9974db9a8c452a6a8318aeefcec6d8b1b20"
+    "8b34056d98b264afef5a4a3e454813fa0e0f288932f8224753d59cabec4f8147"
+    "f183a28f02670c2a1e46b122933c844f48587159064c4cfcc12ad70e4b3a71f9"
+    "2849accf7f79dbb30ad9d6602665f39da09622b01c38c0149dc091deb4c7647b"
+    "d30376eb3993fda5f0781186002ffe269ee69b2cc7451c2dba7e786a8b884b1a"
+    "541a7743aa0db42b0597427439344250d71efc229f579964ecb845ec75e68ba0"
+};
+
+static const char *EXPECTED_32[] = {
+    "987fac64f0bc70532e7848fcda0e091b8004ebda81cf41dd6bba7278071316e0"
+    "9b067618e5b0e6dc67646885d9deaacf31a77a840bcad80f5658610ff779a66d"
+    "85337e47309bd116ff8d9501aa0848257659752dbb9820f72cde53e14e59a276"
+    "093eed64a5cecf1e4c786c46408008ad183ac9d05e8f3b1f7dfc17204510b695"
+    "fcbb32cbec23997c1b12e4fd051cacf18f91649d41de818dbf71224ec18bd9da"
+    "396d9de139ef74b93cd808331c053e390e76e6f1138f0366e738a5208183dbfb"
+    "e48c3efe45ae59801c76e23c1e49a74ab794ce9167d80b4abfa5df0253e18dd0"
+    "b6a7276d2cc9ef0702a97fdf63ba7e40bd228a9ba9e9fedff512591c7f12a9ec",
+    "f6ac5b009ef06048e6749e7ae64b55fb445aa69f11571ebdfa352563d200caec"
+    "f43169846c8301380718f45b4141d026042c29203f9d9e564baa40c0c3c704d6"
+    "aa91b273973ba26a707475945181644df2f8982dedec84b6f6ff78f57c090220"
+    "6bb2d738bf30abdef805b31a2418c331f0c5d610e9c480ab2e94d5da3caf6bb7"
+    "9f91bdc8607c6d6aacbe9c7c229b3ad4248a3c2d5d7f81715c8baad792e33777"
+    "f39d7eb89c9627915d14f8c03c166f6e24fced5cca3339f06b8e21270b69f679"
+    "99236e06639bd9d3fc2888ce53732174595fcc4014512cb77cbc3908df50bea4"
+    "b93d44d2b9078f28f46b13abd14fd16235e78ee97a34b5bc9ac03ed9a66b8104"
+};
+
+/*
+ * Limbs from a big endian byte array of exactly 8N bytes.
+ */
+template<unsigned N>
+static FixedInteger<N> limbs(const coder::ByteArray& bytes) {
+
+    FixedInteger<N> x;
+    for (unsigned i = 0; i < N * 8; ++i) {
+        x[i / 8] |= uint64_t(bytes[(N * 8) - i - 1]) << ((i % 8) * 8);
+    }
+    return x;
+
+}
+
+template<unsigned N>
+static coder::ByteArray bytes(const FixedInteger<N>& x) {
+
+    coder::ByteArray b(N * 8, 0);
+    for (unsigned i = 0; i < N * 8; ++i) {
+        b[(N * 8) - i - 1] = x[i / 8] >> ((i % 8) * 8);
+    }
+    return b;
+
+}
+
+template<unsigned N>
+static void test(const char **expected, int& failed) {
+
+    std::string size(std::to_string(N) + " limb ");
+    unsigned length = N * 8;
+
+    coder::ByteArray modulus(length, 0xff);
+    modulus[length - 1] = 0x61;
+    coder::ByteArray base;
+    coder::ByteArray exp;
+    for (unsigned i = 0; i < length; ++i) {
+        base.append((i * 29) + 11);
+        exp.append((i * 13) + 5);
+    }
+    exp[0] = exp[0] | 0x80;
+    coder::ByteArray publicExp(length, 0);
+    publicExp[length - 3] = 0x01;
+    publicExp[length - 1] = 0x01;
+
+    coder::ByteArray privateResult(fromHex(expected[0]));
+    coder::ByteArray publicResult(fromHex(expected[1]));
+
+    // n0 = -n^-1 mod 2^64 by Newton's iteration, and R^2 mod n is 159^2
+    // because R = n + 159.
+    FixedInteger<N> n(limbs<N>(modulus));
+    uint64_t inverse = n[0];
+    for (unsigned i = 0; i < 5; ++i) {
+        inverse *= 2 - (n[0] * inverse);
+    }
+    FixedInteger<N> r2;
+    r2[0] = 159 * 159;
+    FixedMontgomery<N> mont(n, r2, 0 - inverse);
+
+    FixedInteger<N> x;
+    mont.modPow(x, limbs<N>(base), limbs<N>(exp));
+    check(bytes<N>(x) == privateResult, size + "private exponent", failed);
+    mont.modPow(x, limbs<N>(base), limbs<N>(publicExp));
+    check(bytes<N>(x) == publicResult, size + "public exponent", failed);
+
+    // (n - 1)^2 = 1 mod n. The product overflows R before the
+    // subtraction, which has to take the carry out of the top limb.
+    FixedInteger<N> nLess1(n);
+    nLess1[0] -= 1;
+    FixedInteger<N> one;
+    mont.multiply(x, nLess1, nLess1);
+    mont.multiply(x, x, r2);
+    one[0] = 1;
+    check(bytes<N>(x) == bytes<N>(one), size + "(n - 1)^2", failed);
+    mont.square(x, nLess1);
+    mont.multiply(x, x, r2);
+    check(bytes<N>(x) == bytes<N>(one), size + "square (n - 1)", failed);
+
+    MontgomeryContext context((BigInteger(modulus)));
+    check(context.modPow(BigInteger(base), BigInteger(exp))
+                == BigInteger(privateResult), size + "context private exponent", failed);
+    check(context.modPow(BigInteger(base), BigInteger(65537))
+                == BigInteger(publicResult), size + "context public exponent", failed);
+
+}
+
+int main() {
+
+    int failed = 0;
+    test<16>(EXPECTED_16, failed);
+    test<24>(EXPECTED_24, failed);
+    test<32>(EXPECTED_32, failed);
+
+    std::cout << (failed == 0 ? "Montgomery tests passed"
+                              : "Montgomery tests failed") << std::endl;
+    return failed == 0 ? 0 : 1;
+
+}
@@ -0,0 +1,67 @@
+#include "mac/PBKDF2.h"
+#include "digest/SHA1.h"
+#include "TestVectors.h"
+#include <iostream>
+#include <vector>
+
+using namespace CK;
+
+/*
+ * RFC 6070 known answers for PBKDF2-HMAC-SHA1, on one thread and on
+ * four. The 25 byte case spans two blocks, so the threaded run derives
+ * its blocks in parallel. The 16777216 iteration case is left out for
+ * its running time.
+ */
+
+struct TestCase {
+    std::string password;
+    std::string salt;
+    unsigned iterations;
+    const char *dk;
+};
+
+static const TestCase CASES[] = {
+    { "password", "salt", 1, "0c60c80f961f0e71f3a9b524af6012062fe037a6" },
+    { "password", "salt", 2, "ea6c014dc72d6f8ccd1ed92ace1d41f0d8de8957" },
+    { "password", "salt", 4096, "4b007901b765489abead49d926f721d065a429c1" },
+    { "passwordPASSWORDpassword", "saltSALTsaltSALTsaltSALTsaltSALTsalt", 4096,
+      "3d2eec4fe41c849b80c8d83662c0e44a8b291a964cf2f07038" },
+    { std::string("pass\0word", 9), std::string("sa\0lt", 5), 4096,
+      "56fa6aa75548099dcc37d7f03425e0c3" }
+};
+
+static coder::ByteArray bytes(const std::string& str) {
+
+    return coder::ByteArray(reinterpret_cast<const uint8_t*>(str.data()), str.length());
+
+}
+
+int main() {
+
+    int failed = 0;
+
+    unsigned threads[] = { 1, 4 };
+    for (unsigned t = 0; t < 2; ++t) {
+        PBKDF2 pbkdf2(new SHA1, threads[t]);
+        for (unsigned c = 0; c < 5; ++c) {
+            const TestCase& tc(CASES[c]);
+            coder::ByteArray dk(fromHex(tc.dk));
+            unsigned length = dk.getLength();
+            std::string name("PBKDF2 test case " + std::to_string(c + 1) + " on "
+                                            + std::to_string(threads[t]) + " threads");
+
+            check(pbkdf2.deriveKey(bytes(tc.password), bytes(tc.salt), tc.iterations, length)
+                                            == dk, name, failed);
+
+            std::vector<uint8_t> out(length);
+            pbkdf2.deriveKey(bytes(tc.password), bytes(tc.salt), tc.iterations,
+                                            out.data(), length);
+            check(coder::ByteArray(out.data(), length) == dk,
+                                            name + " into a buffer", failed);
+        }
+    }
+
+    std::cout << (failed == 0 ? "PBKDF2 tests passed" : "PBKDF2 tests failed") << std::endl;
+    return failed == 0 ? 0 : 1;
+
+}
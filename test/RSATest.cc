@@ -0,0 +1,133 @@
+#include "cipher/PKCS1rsassa.h"
+#include "cipher/OAEPrsaes.h"
+#include "keys/RSAPrivateCrtKey.h"
+#include "keys/RSAPrivateModKey.h"
+#include "keys/RSAPublicKey.h"
+#include "digest/SHA256.h"
+#include "TestVectors.h"
+#include <iostream>
+
+using namespace CK;
+
+/*
+ * Known answers for PKCS #1 v1.5 RSA signatures with SHA-256 and a
+ * fixed 2048 bit key, and OAEP round trips. The signatures are made
+ * with the CRT key, whose halves use the cached 1024 bit Montgomery
+ * contexts, on one thread and on two, and with the plain modulus key,
+ * which uses the 2048 bit one. The messages are also signed as one
+ * batch. Verification and encryption use the public key's context. The
+ * answers were computed with Python's pow().
+ */
+
+static const char *P =
+    "fab226068918ac11e12fdf4cf0488a0c52bee79d18b7b79991fa50f1e45a8066"
+    "8240fa1c83c49a44d4fad1eb83f4e06301509b4fb1e23e32bcd28393376d0c1d"
+    "8788da460c9d2be723fbacb8f92d17c56f797a996a2cd3461f88402d176084c1"
+    "4863e590cb5b29201b40e0afce8721ba332f04ea8321f56d1c6f67933fdab10f";
+
+static const char *Q =
+    "f3cf1a45dd9853e147354e5b34d68b59d91c0bb9fc27734c2510f443a5e7098f"
+    "bf15e7b8c28c9702a10aa362475cb59d59e301fe5b199f0c5cac5a491b5d8d89"
+    "45f4d0e33fdc52a9c799658bc85f2f3368dcbcf19a97c1b05afa4c98f8a5fdc1"
+    "15f70860ef93f30a118cb45632dd270ca0085b25a96b9115338b2953e463a39d";
+
+static const std::string MESSAGES[] = {
+    "",
+    "abc",
+    "The quick brown fox jumps over the lazy dog",
+    std::string(1000, 'a')
+};
+
+static const char *SIGNATURES[] = {
+    "bce049a42694d0917dca2298971f1fce3576161c15ac205d50f8d502bdca9fd2"
+    "f3ee13938e179aced51c1c05c3c9b2c70ab05f737c4544c94ceeb6958b73d9a9"
+    "6ed3780c94b3619cfac2b7124987fa3a35c3196728a118240813908548e237c8"
+    "102c99c57099723d4a49832f5ad48ab8435ad1cb55ce33d7b96657367c6685aa"
+    "0bb002bb98332b8faa82941c0ca261824731f7d65a7c8d032b9e2d4511fde985"
+    "1aa047bf21bf0c1b7980d6d55c0025e29538ce33f6f042f2950024376ea98017"
+    "29c9a23ee150adb0688c6c281244c04d99e1259a0c5262d27751ef2e06c5ef7b"
+    "a238976006e2163fcc66e4f81a69008e2a2154edfb0e9aa78fd57bc52891314e",
+    "61b168ff140f49d4085bb9180f399158c04b07857f6b524ccf31d7e1888ce2c9"
+    "e94cbdaa6c2e716710129ba2959a22f6fec3ebbf8b482fccccea204a2d56d06c"
+    "ba76e87d23b2e65460b40b0dd2dd3ee8b155d7f4aa76913b89648ec3014030e6"
+    "5f496da1eb98ea8066b71dc5020967a1e4b7e63775e0675ae8e15732cc83becc"
+    "d889be91a01b460c76f32b6a9b173c31cc996f90f7565c3bdb40060ea7ecda82"
+    "54ddd44884ab19368ea41d8908597ffd97aa7d8c4ea471d1e8ad9bd87c4ad55c"
+    "81f4378d4d1fe024fc7d7174e4af93449b8592d8ef1d575c928fd0bf6b79cb37"
+    "464d18a6b5e0eb18b699daef1e25acc3faa6c7a150ea422d2f18fd1cbfec6f9a",
+    "2a8392c4f63b264224def1ac0eebe6afc41194634067775cf7acf62935478126"
+    "64265c636a1318d500c5a8f026cd97facb91a265fee1c1a1e9fca28b92df5909"
+    "467318ad6ca145daa0f787581e18a1615f44e118c88f4f5e138b0f2a2008966a"
+    "08319aa4d4775ba559f508a3f2d1947101f8e5f387709a51dce11c7df9fdf76d"
+    "a135e9f62a6a698669d91925f1a8c92352660d9573a34adfdc23317efe09c21e"
+    "9936663a2a2e5bb65c389e47eae2ce8ad87bb1bf4fd083fc18f81828314e3cbd"
+    "1f16fbeaf0d33d8de5f9f883db24419c908f19fff7a17b6dbdfb8eefa4e0bf18"
+    "72a65d44f6793651fb9a21d244e4b111638976b40c0da9ef6db675cebd6abb4d",
+    "02fa0c9526f2757bcf3029abccd473a51e1f7079584650fa7e98d26bd73b6a39"
+    "46571f666ad917b577af6a1c1a8d10ce7b472b75cc856040e15e1402bc22a263"
+    "5afee0d10f5b29586fe284bfac19d3a723ed957ab3489e178c8822996316111e"
+    "1df130bf366f0b146e8d40bce19efec99e2df4c750d99bb7121cc652e0ca382e"
+    "124343443bf75319836ae9bdf780f6bf6f499790d6aa641882b74655294d5ce2"
+    "3f6717ba3cf46268f8d10f8a58c42074d8fec8459dceb2cf9d0ca868e76c757d"
+    "a976b9f3e05d601d104c1b2e490e4c76182f809f0df9a81d3bf185cf0c2236ba"
+    "e75aa83157d625de7cd44076e724526cfa96f6caaf6a269ed972c77010414558"
+};
+
+static coder::ByteArray bytes(const std::string& str) {
+
+    return coder::ByteArray(reinterpret_cast<const uint8_t*>(str.data()), str.length());
+
+}
+
+static void testKey(const RSAPrivateKey& key, const RSAPublicKey& pub,
+                                        const std::string& name, int& failed) {
+
+    PKCS1rsassa pkcs1(new SHA256);
+    for (unsigned m = 0; m < 4; ++m) {
+        coder::ByteArray signature(pkcs1.sign(key, bytes(MESSAGES[m])));
+        std::string test(name + " message " + std::to_string(m));
+        check(signature == fromHex(SIGNATURES[m]), test + " signature", failed);
+        check(pkcs1.verify(pub, bytes(MESSAGES[m]), signature), test + " verify", failed);
+    }
+
+    RSA::Messages messages;
+    for (unsigned m = 0; m < 4; ++m) {
+        messages.push_back(bytes(MESSAGES[m]));
+    }
+    RSA::Signatures signatures(pkcs1.sign(key, messages));
+    check(signatures.size() == 4, name + " batch size", failed);
+    for (unsigned m = 0; m < 4 && m < signatures.size(); ++m) {
+        check(signatures[m] == fromHex(SIGNATURES[m]),
+                name + " batch signature " + std::to_string(m), failed);
+    }
+
+    OAEPrsaes oaep(OAEPrsaes::sha256);
+    oaep.setSeed(coder::ByteArray(32, 0x5a));
+    coder::ByteArray plaintext(bytes(MESSAGES[2]));
+    check(oaep.decrypt(key, oaep.encrypt(pub, plaintext)) == plaintext,
+                                        name + " OAEP round trip", failed);
+
+}
+
+int main() {
+
+    int failed = 0;
+
+    BigInteger p(fromHex(P));
+    BigInteger q(fromHex(Q));
+    BigInteger e(65537L);
+    BigInteger n(p * q);
+    BigInteger d(e.modInverse((p - BigInteger::ONE) * (q - BigInteger::ONE)));
+    RSAPublicKey pub(n, e);
+
+    RSAPrivateCrtKey crt(p, q, d, e);
+    testKey(crt, pub, "RSA CRT key", failed);
+    crt.setParallel(true);
+    testKey(crt, pub, "RSA parallel CRT key", failed);
+    RSAPrivateModKey mod(d, n);
+    testKey(mod, pub, "RSA modulus key", failed);
+
+    std::cout << (failed == 0 ? "RSA tests passed" : "RSA tests failed") << std::endl;
+    return failed == 0 ? 0 : 1;
+
+}
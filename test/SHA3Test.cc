@@ -0,0 +1,156 @@
+#include "digest/SHA3.h"
+#include "digest/SHAKE.h"
+#include "digest/SHA256.h"
+#include "TestVectors.h"
+#include <algorithm>
+#include <iostream>
+
+using namespace CK;
+
+/*
+ * FIPS 202 known answers for SHA-3 and SHAKE. The messages include
+ * the 1600 bit 0xa3 example, which spans the rate of every variant.
+ * Each message is hashed in one update and again a byte at a time.
+ * The length sweeps cover every padding case, and the 4096 byte
+ * SHAKE outputs are squeezed in uneven pieces and compared by their
+ * SHA-256 digests. The answers were computed with Python's hashlib.
+ */
+
+static const std::string MESSAGES[] = {
+    "",
+    "abc",
+    std::string(200, '\xa3'),
+    "abcdefghbcdefghicdefghijdefghijkefghijklfghijklmghijklmn"
+    "hijklmnoijklmnopjklmnopqklmnopqrlmnopqrsmnopqrstnopqrstu"
+};
+
+// The messages, then the length sweep.
+static const char *SHA3_224_EXPECTED[] = {
+    "6b4e03423667dbb73b6e15454f0eb1abd4597f9a1b078e3f5b5a6bc7",
+    "e642824c3f8cf24ad09234ee7d3c766fc9a3a5168d0c94ad73b46fdf",
+    "9376816aba503f72f96ce7eb65ac095deee3be4bf9bbc2a1cb7e11e0",
+    "543e6868e1666c1a643630df77367ae5a62a85070a51c14cbf665cbc",
+    "38d722a10c3d546c77aad8a72cff8e72cd00ad18fe0a4a3d47923d6f"
+};
+
+static const char *SHA3_256_EXPECTED[] = {
+    "a7ffc6f8bf1ed76651c14756a061d662f580ff4de43b49fa82d80a4b80f8434a",
+    "3a985da74fe225b2045c172d6bd390bd855f086e3e9d525b46bfe24511431532",
+    "79f38adec5c20307a98ef76e8324afbfd46cfd81b22e3973c65fa1bd9de31787",
+    "916f6061fe879741ca6469b43971dfdb28b1a32dc36cb3254e812be27aad1d18",
+    "b5554387ee83c5350ed9f05a86174adf0c63ac29a9ef3e6ac815a11ddb3847ce"
+};
+
+static const char *SHA3_384_EXPECTED[] = {
+    "0c63a75b845e4f7d01107d852e4c2485c51a50aaaa94fc61"
+    "995e71bbee983a2ac3713831264adb47fb6bd1e058d5f004",
+    "ec01498288516fc926459f58e2c6ad8df9b473cb0fc08c25"
+    "96da7cf0e49be4b298d88cea927ac7f539f1edf228376d25",
+    "1881de2ca7e41ef95dc4732b8f5f002b189cc1e42b74168e"
+    "d1732649ce1dbcdd76197a31fd55ee989f2d7050dd473e8f",
+    "79407d3b5916b59c3e30b09822974791c313fb9ecc849e40"
+    "6f23592d04f625dc8c709b98b43b3852b337216179aa7fc7",
+    "d619967fcd4fbdc37cbb7305dbb11c8d8ab720ccec711b6d"
+    "f960a146293ae7ac26d50019721e9c7a1a86e62c5bf2f1f4"
+};
+
+static const char *SHA3_512_EXPECTED[] = {
+    "a69f73cca23a9ac5c8b567dc185a756e97c982164fe25859e0d1dcc1475c80a6"
+    "15b2123af1f5f94c11e3e9402c3ac558f500199d95b6d3e301758586281dcd26",
+    "b751850b1a57168a5693cd924b6b096e08f621827444f70d884f5d0240d2712e"
+    "10e116e9192af3c91a7ec57647e3934057340b4cf408d5a56592f8274eec53f0",
+    "e76dfad22084a8b1467fcf2ffa58361bec7628edf5f3fdc0e4805dc48caeeca8"
+    "1b7c13c30adf52a3659584739a2df46be589c51ca1a4a8416df6545a1ce8ba00",
+    "afebb2ef542e6579c50cad06d2e578f9f8dd6881d7dc824d26360feebf18a4fa"
+    "73e3261122948efcfd492e74e82e2189ed0fb440d187f382270cb455f21dd185",
+    "d2fcbb70dc57b3892091c7bd05e70ef1168e8aedf0d9e8b0b4f4bc6b4caba928"
+    "3185c1701f50a0f29c7562e7e2d955da984c117f9102a50adf286521f9e1c953"
+};
+
+// The messages, then the SHA-256 digest of 4096 bytes of output for
+// the 0xa3 message.
+static const char *SHAKE128_EXPECTED[] = {
+    "7f9c2ba4e88f827d616045507605853ed73b8093f6efbc88eb1a6eacfa66ef26",
+    "5881092dd818bf5cf8a3ddb793fbcba74097d5c526a6d35f97b83351940f2cc8",
+    "131ab8d2b594946b9c81333f9bb6e0ce75c3b93104fa3469d3917457385da037",
+    "7b6df6ff181173b6d7898d7ff63fb07b7c237daf471a5ae5602adbccef9ccf4b",
+    "168a5b509e8a33ad18e164ec1e06487f34cbd89c85e95fa770e2f4a750768fa6"
+};
+
+static const char *SHAKE256_EXPECTED[] = {
+    "46b9dd2b0ba88d13233b3feb743eeb243fcd52ea62b81b82b50c27646ed5762f"
+    "d75dc4ddd8c0f200cb05019d67b592f6fc821c49479ab48640292eacb3b7c4be",
+    "483366601360a8771c6863080cc4114d8db44530f8f1e1ee4f94ea37e78b5739"
+    "d5a15bef186a5386c75744c0527e1faa9f8726e462a12a4feb06bd8801e751e4",
+    "cd8a920ed141aa0407a22d59288652e9d9f1a7ee0c1e7c1ca699424da84a904d"
+    "2d700caae7396ece96604440577da4f3aa22aeb8857f961c4cd8e06f0ae6610b",
+    "98be04516c04cc73593fef3ed0352ea9f6443942d6950e29a372a681c3deaf45"
+    "35423709b02843948684e029010badcc0acd8303fc85fdad3eabf4f78cae1656",
+    "cedfffd4f9742a60cd63949c771ab5146d415c139a1f1b6fd6a3d4270a183690"
+};
+
+static void testVectors(Digest& digest, const std::string& name,
+                                        const char **expected, int& failed) {
+
+    for (unsigned m = 0; m < 4; ++m) {
+        const std::string& message(MESSAGES[m]);
+        const uint8_t *bytes = reinterpret_cast<const uint8_t*>(message.data());
+        coder::ByteArray answer(fromHex(expected[m]));
+
+        digest.update(bytes, message.length());
+        check(digest.digest() == answer, name + " message " + std::to_string(m), failed);
+
+        for (unsigned i = 0; i < message.length(); ++i) {
+            digest.update(bytes[i]);
+        }
+        check(digest.digest() == answer,
+                name + " message " + std::to_string(m) + " in pieces", failed);
+    }
+
+}
+
+// Squeeze 4096 bytes in pieces of 1 to 200 bytes.
+static void testSqueeze(SHAKE& shake, const std::string& name,
+                                        const char *expected, int& failed) {
+
+    const std::string& message(MESSAGES[2]);
+    shake.update(reinterpret_cast<const uint8_t*>(message.data()), message.length());
+    coder::ByteArray output;
+    unsigned piece = 1;
+    while (output.getLength() < 4096) {
+        unsigned count = std::min<unsigned>(piece, 4096 - output.getLength());
+        output.append(shake.squeeze(count));
+        piece = piece % 200 + 37;
+    }
+    shake.reset();
+
+    SHA256 sha;
+    check(sha.digest(output) == fromHex(expected), name + " squeeze", failed);
+
+}
+
+int main() {
+
+    int failed = 0;
+
+    unsigned lengths[] = { 28, 32, 48, 64 };
+    const char **expected[] = { SHA3_224_EXPECTED, SHA3_256_EXPECTED,
+                                SHA3_384_EXPECTED, SHA3_512_EXPECTED };
+    for (unsigned l = 0; l < 4; ++l) {
+        SHA3 sha3(lengths[l]);
+        std::string name("SHA3-" + std::to_string(lengths[l] * 8));
+        testVectors(sha3, name, expected[l], failed);
+        check(sweep(sha3) == fromHex(expected[l][4]), name + " sweep", failed);
+    }
+
+    SHAKE shake128(128, 32);
+    testVectors(shake128, "SHAKE128", SHAKE128_EXPECTED, failed);
+    testSqueeze(shake128, "SHAKE128", SHAKE128_EXPECTED[4], failed);
+    SHAKE shake256(256, 64);
+    testVectors(shake256, "SHAKE256", SHAKE256_EXPECTED, failed);
+    testSqueeze(shake256, "SHAKE256", SHAKE256_EXPECTED[4], failed);
+
+    std::cout << (failed == 0 ? "SHA-3 tests passed" : "SHA-3 tests failed") << std::endl;
+    return failed == 0 ? 0 : 1;
+
+}
@@ -0,0 +1,155 @@
+#include "digest/SHA1.h"
+#include "digest/SHA224.h"
+#include "digest/SHA256.h"
+#include "digest/SHA384.h"
+#include "digest/SHA512.h"
+#include "digest/SHA512_256.h"
+#include "data/CPUFeatures.h"
+#include "TestVectors.h"
+#include <iostream>
+
+using namespace CK;
+
+/*
+ * FIPS 180-4 known answers for the SHA family. Each message is hashed
+ * in one update and again a byte at a time, or in 1000 byte pieces
+ * for the million byte message, so the chunk buffering is checked at
+ * every offset.
+ *
+ * The sweeps hash messages of every length from 0 to 299 bytes, which
+ * covers every padding case, through whichever compression function
+ * the CPU selects. Their answers were computed with Python's hashlib.
+ */
+
+static const std::string MESSAGES[] = {
+    "",
+    "abc",
+    "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq",
+    "abcdefghbcdefghicdefghijdefghijkefghijklfghijklmghijklmn"
+    "hijklmnoijklmnopjklmnopqklmnopqrlmnopqrsmnopqrstnopqrstu",
+    std::string(1000000, 'a')
+};
+
+static const char *SHA1_EXPECTED[] = {
+    "da39a3ee5e6b4b0d3255bfef95601890afd80709",
+    "a9993e364706816aba3e25717850c26c9cd0d89d",
+    "84983e441c3bd26ebaae4aa1f95129e5e54670f1",
+    "a49b2446a02c645bf419f995b67091253a04a259",
+    "34aa973cd4c4daa4f61eeb2bdbad27316534016f"
+};
+
+static const char *SHA224_EXPECTED[] = {
+    "d14a028c2a3a2bc9476102bb288234c415a2b01f828ea62ac5b3e42f",
+    "23097d223405d8228642a477bda255b32aadbce4bda0b3f7e36c9da7",
+    "75388b16512776cc5dba5da1fd890150b0c6455cb4f58b1952522525",
+    "c97ca9a559850ce97a04a96def6d99a9e0e0e2ab14e6b8df265fc0b3",
+    "20794655980c91d8bbb4c1ea97618a4bf03f42581948b2ee4ee7ad67"
+};
+
+static const char *SHA256_EXPECTED[] = {
+    "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855",
+    "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad",
+    "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1",
+    "cf5b16a778af8380036ce59e7b0492370b249b11e8f07a51afac45037afee9d1",
+    "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0"
+};
+
+static const char *SHA384_EXPECTED[] = {
+    "38b060a751ac96384cd9327eb1b1e36a21fdb71114be0743"
+    "4c0cc7bf63f6e1da274edebfe76f65fbd51ad2f14898b95b",
+    "cb00753f45a35e8bb5a03d699ac65007272c32ab0eded163"
+    "1a8b605a43ff5bed8086072ba1e7cc2358baeca134c825a7",
+    "3391fdddfc8dc7393707a65b1b4709397cf8b1d162af05ab"
+    "fe8f450de5f36bc6b0455a8520bc4e6f5fe95b1fe3c8452b",
+    "09330c33f71147e83d192fc782cd1b4753111b173b3b05d2"
+    "2fa08086e3b0f712fcc7c71a557e2db966c3e9fa91746039",
+    "9d0e1809716474cb086e834e310a4a1ced149e9c00f24852"
+    "7972cec5704c2a5b07b8b3dc38ecc4ebae97ddd87f3d8985"
+};
+
+static const char *SHA512_EXPECTED[] = {
+    "cf83e1357eefb8bdf1542850d66d8007d620e4050b5715dc83f4a921d36ce9ce"
+    "47d0d13c5d85f2b0ff8318d2877eec2f63b931bd47417a81a538327af927da3e",
+    "ddaf35a193617abacc417349ae20413112e6fa4e89a97ea20a9eeee64b55d39a"
+    "2192992a274fc1a836ba3c23a3feebbd454d4423643ce80e2a9ac94fa54ca49f",
+    "204a8fc6dda82f0a0ced7beb8e08a41657c16ef468b228a8279be331a703c335"
+    "96fd15c13b1b07f9aa1d3bea57789ca031ad85c7a71dd70354ec631238ca3445",
+    "8e959b75dae313da8cf4f72814fc143f8f7779c6eb9f7fa17299aeadb6889018"
+    "501d289e4900f7e4331b99dec4b5433ac7d329eeb6dd26545e96e55b874be909",
+    "e718483d0ce769644e2e42c7bc15b4638e1f98b13b2044285632a803afa973eb"
+    "de0ff244877ea60a4cb0432ce577c31beb009c5c2c49aa2e4eadb217ad8cc09b"
+};
+
+static const char *SHA512_256_EXPECTED[] = {
+    "c672b8d1ef56ed28ab87c3622c5114069bdd3ad7b8f9737498d0c01ecef0967a",
+    "53048e2681941ef99b2e29b76b4c7dabe4c2d0c634fc6d46e0e2f13107e7af23",
+    "bde8e1f9f19bb9fd3406c90ec6bc47bd36d8ada9f11880dbc8a22a7078b6a461",
+    "3928e184fb8690f840da3988121d31be65cb9d3ef83ee6146feac861e19b563a",
+    "9a59a052930187a97038cae692f30708aa6491923ef5194394dc68d56c74fb21"
+};
+
+static const char *SHA1_SWEEP = "b9d956d3a9b44baa2d20ff7053a790ca0c1c0797";
+static const char *SHA224_SWEEP =
+    "de342ba35f573888d178f2815ddce62b373c5d64a7d426b3925d3ebb";
+static const char *SHA256_SWEEP =
+    "148b894486945a24e834868db010090f61da189d018f0bf543b188081480175d";
+static const char *SHA384_SWEEP =
+    "b7b4e88a8072335c083ffb0019f252d79aa8be223475c4ab"
+    "7fa1ec024eddf4d224e1a2e680ec3b1c91aa7bb9567e8333";
+static const char *SHA512_SWEEP =
+    "ad822927061178037f606349701a35f5094cda5a23cfe758f80ff191c3800415"
+    "81924348bc3c444be7a3e86ba0225a1f770f93f93256d0da1133d487d14c059e";
+static const char *SHA512_256_SWEEP =
+    "5f8161bc2ff180f6e5fbd0e5149c1e256c1ca60364971e2db1e356aabb4e1aff";
+
+static void testVectors(Digest& digest, const std::string& name,
+                                        const char **expected, int& failed) {
+
+    for (unsigned m = 0; m < 5; ++m) {
+        const std::string& message(MESSAGES[m]);
+        const uint8_t *bytes = reinterpret_cast<const uint8_t*>(message.data());
+        coder::ByteArray answer(fromHex(expected[m]));
+
+        digest.update(bytes, message.length());
+        check(digest.digest() == answer, name + " message " + std::to_string(m), failed);
+
+        unsigned piece = message.length() > 1000 ? 1000 : 1;
+        for (unsigned i = 0; i < message.length(); i += piece) {
+            digest.update(bytes + i, piece);
+        }
+        check(digest.digest() == answer,
+                name + " message " + std::to_string(m) + " in pieces", failed);
+    }
+
+}
+
+int main() {
+
+    int failed = 0;
+    std::string sha(CPUFeatures::hasSHA() ? " with SHA extensions" : "");
+    std::string avx2(CPUFeatures::hasAVX2() ? " with AVX2" : "");
+
+    SHA1 sha1;
+    testVectors(sha1, "SHA-1" + sha, SHA1_EXPECTED, failed);
+    check(sweep(sha1) == fromHex(SHA1_SWEEP), "SHA-1" + sha + " sweep", failed);
+    SHA224 sha224;
+    testVectors(sha224, "SHA-224" + sha, SHA224_EXPECTED, failed);
+    check(sweep(sha224) == fromHex(SHA224_SWEEP), "SHA-224" + sha + " sweep", failed);
+    SHA256 sha256;
+    testVectors(sha256, "SHA-256" + sha, SHA256_EXPECTED, failed);
+    check(sweep(sha256) == fromHex(SHA256_SWEEP), "SHA-256" + sha + " sweep", failed);
+    SHA384 sha384;
+    testVectors(sha384, "SHA-384" + avx2, SHA384_EXPECTED, failed);
+    check(sweep(sha384) == fromHex(SHA384_SWEEP), "SHA-384" + avx2 + " sweep", failed);
+    SHA512 sha512;
+    testVectors(sha512, "SHA-512" + avx2, SHA512_EXPECTED, failed);
+    check(sweep(sha512) == fromHex(SHA512_SWEEP), "SHA-512" + avx2 + " sweep", failed);
+    SHA512_256 sha512_256;
+    testVectors(sha512_256, "SHA-512/256" + avx2, SHA512_256_EXPECTED, failed);
+    check(sweep(sha512_256) == fromHex(SHA512_256_SWEEP),
+                                    "SHA-512/256" + avx2 + " sweep", failed);
+
+    std::cout << (failed == 0 ? "SHA tests passed" : "SHA tests failed") << std::endl;
+    return failed == 0 ? 0 : 1;
+
+}
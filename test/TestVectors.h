@@ -0,0 +1,50 @@
+#ifndef TESTVECTORS_H_INCLUDED
+#define TESTVECTORS_H_INCLUDED
+
+#include "digest/Digest.h"
+#include <coder/ByteArray.h>
+#include <iostream>
+#include <string>
+
+/*
+ * Helpers for the known-answer tests.
+ */
+
+// Decode a string of hex digits.
+inline coder::ByteArray fromHex(const std::string& hex) {
+
+    coder::ByteArray bytes;
+    for (unsigned i = 0; i + 1 < hex.length(); i += 2) {
+        bytes.append(std::stoul(hex.substr(i, 2), 0, 16));
+    }
+    return bytes;
+
+}
+
+// Count and report a result that doesn't match.
+inline void check(bool passed, const std::string& name, int& failed) {
+
+    if (!passed) {
+        std::cout << name << " failed" << std::endl;
+        failed++;
+    }
+
+}
+
+// The digest of the digests of the messages i * 31 + length, for
+// every length from 0 to 299 bytes.
+inline coder::ByteArray sweep(CK::Digest& digest) {
+
+    coder::ByteArray digests;
+    for (unsigned length = 0; length < 300; ++length) {
+        coder::ByteArray message;
+        for (unsigned i = 0; i < length; ++i) {
+            message.append(i * 31 + length);
+        }
+        digests.append(digest.digest(message));
+    }
+    return digest.digest(digests);
+
+}
+
+#endif  // TESTVECTORS_H_INCLUDED
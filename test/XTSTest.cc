@@ -0,0 +1,147 @@
+#include "ciphermodes/XTS.h"
+#include "cipher/AES.h"
+#include "digest/SHA256.h"
+#include "exceptions/BadParameterException.h"
+#include "TestVectors.h"
+#include <iostream>
+
+using namespace CK;
+
+/*
+ * Known answers for XTS-AES. The IEEE 1619 vectors cover a whole
+ * block unit and ciphertext stealing from 17 to 20 bytes. The longer
+ * units run from 16 to 4096 bytes and are compared by their SHA-256
+ * digests, as are the runs of 4096 and 520 byte sectors. The digests
+ * were computed with OpenSSL's XTS-AES.
+ */
+
+// IEEE 1619 vectors 15 to 18.
+static const char *STEALING[] = {
+    "6c1625db4671522d3d7599601de7ca09ed",
+    "d069444b7a7e0cab09e24447d24deb1fedbf",
+    "e5df1351c0544ba1350b3363cd8ef4beedbf9d",
+    "9d84c813f719aa2c7be3f66171c7c5c2edbf9dac"
+};
+
+static const unsigned LENGTHS[] = { 16, 17, 31, 32, 33, 47, 48, 100,
+                                    512, 513, 4095, 4096 };
+
+// Ciphertext digests for each length, then the 4096 and 520 byte sector runs.
+static const char *EXPECTED_128[] = {
+    "2ed1a9afe57269c3fd5f3fef3f400889c3e058e3a7e1292b31f350a63e31a6d9",
+    "e0c3ec9aee25d304b322ea4d69bcba05bcb2d750e52fb836e68f13e211160216",
+    "daa66a47239c4e6f541b85cec5a1a79040277862e7851a07c6d0857e9eb0493a",
+    "958d190ef5bbb7b2e2fcdd6b848d5f571fbfe5f53deb105ea774f95883c0e83b",
+    "08d7de8b6d3f9c217b98c8b0d7d75a22121e79ad58897e86375ceaf221c77dda",
+    "b36d8c7d27ad6044cd070901c299b6596381f5bc298535b47673b7283bd74c19",
+    "d7b7191ae8089fabc5c1e7d183fec0fe0c2281295a5915b5b586caeab184f0a9",
+    "d20fa0e663640afcb595a1cf803b177b8dde267437e05e1e99b1d0a60aabc2ee",
+    "9ca41720891432a53b9cc7dff7f583c22898c710f3399e3f035d93649a20b554",
+    "066f4428dc2a9285fb37bb396105a636c76344407b0d4470ff4503d3ee59b983",
+    "852ab4cb5ca8b407bc4022d202e5cb199ff29f9c83413e739bdc68ce9c49ef97",
+    "0a40dedeceff6a1fb791d1af429a4c20114ec26c296cdfc8eec6d0198f9fe943",
+    "5a6bc84903536590fd5bc5919242e52d7d07173525804623ed07fa272c6b91f8",
+    "93e7b73ed83aebb359616859c8dcc6f4b4fb0c938d96c137e4d1f0875816f6c2"
+};
+
+static const char *EXPECTED_256[] = {
+    "158cba2f4d56ab15b0b07d65e142dbb5f74aae4c8640549f8c3bdb11d68b33f6",
+    "81c9b5cb2d3d9efa17cf4af757c1b53625c8c296298b819c05240811680341d6",
+    "c309272c8d5f30ed39ce8c684883ed9cac7bd5fbb5664629c662ef193d83f090",
+    "d6b6d6ff3c593a84e8e3360b46778e18e78ef1cabf1415e2f95c9d553d59bf7f",
+    "e241c3a844d25943a86d8177473c8dbddf1153e101ce3517676d9b93cda47903",
+    "e6a913bba90500e0b239cc585e430f3dd0cfd99d3b358608533ddf89b10819b8",
+    "49d6bce35dbadc7d78d5db3340166738fefc755d030a5dda9c69592c9928ea54",
+    "f100d489ed39e659ad24b2d4e4867193c68a6c0082dd59921bebccc803ba9080",
+    "3cc77a58e167c8417c0bb978572c0be817e8f860235398157c5335226257df4e",
+    "edfa5a635e4ad8bae07c2f754e87c70d6b9a0d44825e49f70fb35955588023ff",
+    "a3fbf9829c2eb6e029985e11bcb713ec78b2f3d772413c4ad869a709a0993b50",
+    "e1ca1eeaa7b91ca3479bc1b40991cd4b4bdbaa6054de09b2bf799ec2cd8ed0c0",
+    "70293585619ac62102df71fbe0c6abff4aa21dea97dcf2eb7dea36ae309d16ad",
+    "34e6feed6c854f304199c94070be2c8b084777e805818e847e3da47c7944a85f"
+};
+
+// Bytes i * step + 7.
+static coder::ByteArray pattern(unsigned length, unsigned step) {
+
+    coder::ByteArray bytes;
+    for (unsigned i = 0; i < length; ++i) {
+        bytes.append(i * step + 7);
+    }
+    return bytes;
+
+}
+
+static bool matches(const coder::ByteArray& ciphertext, const char *expected) {
+
+    SHA256 sha;
+    return sha.digest(ciphertext) == fromHex(expected);
+
+}
+
+int main() {
+
+    int failed = 0;
+
+    XTS ieee(new AES(AES::AES128));
+    coder::ByteArray key(fromHex("1111111111111111111111111111111122222222222222222222222222222222"));
+    ieee.setSector(0x3333333333ULL);
+    check(ieee.encrypt(coder::ByteArray(32, 0x44), key)
+            == fromHex("c454185e6a16936e39334038acef838bfb186fff7480adc4289382ecd6d394f0"),
+            "IEEE 1619 vector 2", failed);
+
+    key = fromHex("fffefdfcfbfaf9f8f7f6f5f4f3f2f1f0bfbebdbcbbbab9b8b7b6b5b4b3b2b1b0");
+    ieee.setSector(0x123456789aULL);
+    for (unsigned v = 0; v < 4; ++v) {
+        coder::ByteArray plaintext;
+        for (unsigned i = 0; i < 17 + v; ++i) {
+            plaintext.append(i);
+        }
+        coder::ByteArray ciphertext(ieee.encrypt(plaintext, key));
+        check(ciphertext == fromHex(STEALING[v])
+                && ieee.decrypt(ciphertext, key) == plaintext,
+                "IEEE 1619 vector " + std::to_string(15 + v), failed);
+    }
+
+    AES::KeySize sizes[] = { AES::AES128, AES::AES256 };
+    const char **expected[] = { EXPECTED_128, EXPECTED_256 };
+    for (unsigned s = 0; s < 2; ++s) {
+        XTS xts(new AES(sizes[s]));
+        key = pattern(sizes[s] * 2, 17);
+        std::string name("XTS-AES-" + std::to_string(sizes[s] * 8) + " ");
+
+        for (unsigned l = 0; l < 12; ++l) {
+            coder::ByteArray plaintext(pattern(LENGTHS[l], 29));
+            xts.setSector(0x123456789aULL);
+            coder::ByteArray ciphertext(xts.encrypt(plaintext, key));
+            check(matches(ciphertext, expected[s][l])
+                    && xts.decrypt(ciphertext, key) == plaintext,
+                    name + std::to_string(LENGTHS[l]) + " bytes", failed);
+        }
+
+        coder::ByteArray plaintext(pattern(4096 * 5, 3));
+        coder::ByteArray ciphertext(xts.encryptSectors(plaintext, key, 1000, 4096));
+        check(matches(ciphertext, expected[s][12])
+                && xts.decryptSectors(ciphertext, key, 1000, 4096) == plaintext,
+                name + "4096 byte sectors", failed);
+
+        plaintext = pattern(520 * 3, 3);
+        ciphertext = xts.encryptSectors(plaintext, key, 7, 520);
+        check(matches(ciphertext, expected[s][13])
+                && xts.decryptSectors(ciphertext, key, 7, 520) == plaintext,
+                name + "520 byte sectors", failed);
+    }
+
+    try {
+        XTS xts(new AES(AES::AES128));
+        xts.encrypt(coder::ByteArray(32, 0x01), coder::ByteArray(32, 0x05));
+        std::cout << "XTS accepted equal data and tweak keys" << std::endl;
+        failed++;
+    }
+    catch (BadParameterException& e) {
+    }
+
+    std::cout << (failed == 0 ? "XTS tests passed" : "XTS tests failed") << std::endl;
+    return failed == 0 ? 0 : 1;
+
+}